@@ -0,0 +1,503 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sched.h>
+#include <pthread.h>
+#include "structs.h"
+#include "parser.h"
+#include "game.h"
+#include "solver.h"
+#include "dlx.h"
+#include "main_aux.h"
+#include "pool.h"
+#define CELL_CHARS "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define OUT_BUF 65536
+#define SLOTS_PER_WORKER 16
+#define RESULT_LEN(N) ((N)*(N)*12 + 32) /*longest line of result of a board - N*N numbers with separators*/
+
+char* batch_op = NULL; /*solve, validate or count, NULL when not in batch mode*/
+char* batch_input = NULL; /*file of the boards, NULL for the standard input*/
+long count_cap = 0; /*stop counting after this many solutions, 0 for no cap*/
+int batch_workers = 0; /*number of solver threads, 0 for all online cores*/
+char out_buf[OUT_BUF]; /*buffer of the standard output in batch mode*/
+
+/**
+ * set_batch_op - selects the operation done on every board, and turns on batch mode.
+ * @param
+ * op - solve (write a solution), validate (write whether the board is solvable) or count (write its number of solutions)
+ * @return
+ * 1 - if op is one of the operations
+ * 0 - otherwise
+ */
+int set_batch_op(char* op) {
+	if (strcmp(op,"solve") && strcmp(op,"validate") && strcmp(op,"count"))
+		return 0;
+	batch_op = op;
+	return 1;
+}
+
+/**
+ * set_batch_input - sets the file the boards are read from.
+ * @param
+ * path - path of the file, "-" for the standard input
+ */
+void set_batch_input(char* path) {
+	batch_input = strcmp(path,"-") ? path : NULL;
+}
+
+/**
+ * set_count_cap - sets the number of solutions after which counting a board stops.
+ * @param
+ * cap - the number of solutions, 0 for no cap
+ */
+void set_count_cap(long cap) {
+	count_cap = cap;
+}
+
+/**
+ * set_batch_workers - sets the number of threads that solve the boards in batch mode.
+ * @param
+ * workers - the number of threads, 0 for all online cores
+ */
+void set_batch_workers(int workers) {
+	batch_workers = workers;
+}
+
+/**
+ * batch_mode - checks whether batch mode was selected.
+ * @return
+ * 1 - if an operation was selected with set_batch_op
+ * 0 - otherwise
+ */
+int batch_mode() {
+	return batch_op != NULL;
+}
+
+/**
+ * Type represents a board on its way through the pipeline of run_pipeline - the reader reads a board into a free slot,
+ * a worker writes the board's result into it, and the writer writes the results out in the order of the input and
+ * hands the slot back to the reader.
+ */
+typedef struct batch_slot {
+	Board* board; /*reused while the boards are of the same size*/
+	int m;
+	int n;
+	int res; /*result of read_board*/
+	long seq; /*position of the board in the input*/
+	char* out; /*the line of result, NULL if it could not be allocated*/
+	int out_cap;
+} BatchSlot;
+
+/**
+ * Type represents the pipeline of run_pipeline - the slots, and the queues of slot indices between the stages.
+ */
+typedef struct pipeline {
+	BatchSlot* slots;
+	int nslots;
+	RingQueue free_slots; /*slots the reader may fill*/
+	RingQueue jobs; /*slots read, and -1 for every worker at the end of the input*/
+	RingQueue done; /*slots with a result*/
+	long* pending; /*slot of each board done before the boards preceding it, by seq % nslots, -1 for none*/
+	long total; /*number of boards read, final once read_done is set*/
+	int read_done;
+	int failed; /*set when the solver failed on a board*/
+	double* busy; /*time each worker spent on boards, in seconds*/
+	double write_secs;
+	double done_depths; /*sum of the depths of the done queue seen by the writer*/
+} Pipeline;
+
+/**
+ * Type represents the argument of one worker thread of the pipeline.
+ */
+typedef struct stage_arg {
+	Pipeline* pipe;
+	int id;
+} StageArg;
+
+/**
+ * format_grid - writes the values of a board in one line - one character per cell (see read_board) when N is at most
+ * 35, and the numbers separated by spaces otherwise.
+ * @param
+ * out - buffer of at least RESULT_LEN(N) characters
+ * grid - N*N values in row-major order
+ * N - number of cells in one row
+ */
+void format_grid(char* out, int* grid, int N) {
+	int idx;
+	for (idx = 0; idx < N*N; idx++) {
+		if (N <= 35)
+			*out++ = CELL_CHARS[grid[idx]];
+		else
+			out += sprintf(out, idx == 0 ? "%d" : " %d", grid[idx]);
+	}
+	strcpy(out, "\n");
+}
+
+/**
+ * batch_board - does the batch operation on a board, and formats its result.
+ * the results are one line each: the solution (see format_grid) or "unsolvable" for solve, "solvable" or "unsolvable"
+ * for validate, and the number of solutions for count. a board with erroneous values gets "erroneous", and a board
+ * the solver failed on gets "error".
+ * @param
+ * board - the board
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * out - buffer of at least RESULT_LEN(m*n) characters, receives the line of result
+ * @return
+ * 1 - on success
+ * 0 - if the solver failed
+ */
+int batch_board(Board* board, int m, int n, char* out) {
+	int* sol; long count;
+	if (erroneous_board(board)) {
+		strcpy(out, "erroneous\n");
+		return 1;
+	}
+	if (!strcmp(batch_op,"count")) {
+		count = count_solutions(board, count_cap, NULL);
+		if (count < 0) {
+			strcpy(out, "error\n");
+			return 0;
+		}
+		sprintf(out, "%ld\n", count);
+		return 1;
+	}
+	sol = solution_grid(board, m, n);
+	if (sol == NULL)
+		strcpy(out, "unsolvable\n");
+	else if (!strcmp(batch_op,"solve"))
+		format_grid(out, sol, m*n);
+	else
+		strcpy(out, "solvable\n");
+	return 1;
+}
+
+/**
+ * do_slot - does the batch operation on the board of a slot, after growing the slot's buffer of result if needed.
+ * @param
+ * slot - the slot, read by read_board
+ * @return
+ * 1 - on success, and for a board that can't be read (its result is "invalid")
+ * 0 - if the solver failed or memory allocation failed
+ */
+int do_slot(BatchSlot* slot) {
+	int len = RESULT_LEN(slot->m*slot->n);
+	if (slot->res > 0 && slot->out_cap < len) {
+		free(slot->out);
+		slot->out = malloc(len);
+		slot->out_cap = slot->out ? len : 0;
+	}
+	else if (!slot->out) {
+		slot->out = malloc(sizeof("invalid\n"));
+		slot->out_cap = slot->out ? (int) sizeof("invalid\n") : 0;
+	}
+	if (!slot->out)
+		return 0;
+	if (slot->res < 0) {
+		strcpy(slot->out, "invalid\n");
+		return 1;
+	}
+	return batch_board(slot->board, slot->m, slot->n, slot->out);
+}
+
+/**
+ * wait_pop - removes the value at the head of a queue, and waits for one while the queue is empty.
+ * @param
+ * q - the queue
+ * val - pointer to the removed value, set by the function
+ */
+void wait_pop(RingQueue* q, long* val) {
+	while (!queue_pop(q, val))
+		sched_yield();
+}
+
+/**
+ * wait_push - adds a value at the tail of a queue, and waits for room while the queue is full.
+ * @param
+ * q - the queue
+ * val - the value
+ */
+void wait_push(RingQueue* q, long val) {
+	while (!queue_push(q, val))
+		sched_yield();
+}
+
+/**
+ * pipeline_worker - a thread of the solving stage - takes read slots off the jobs queue and passes them to the writer
+ * with their results, until it takes -1.
+ * @param
+ * arg - the StageArg of the thread
+ * @return
+ * NULL
+ */
+void* pipeline_worker(void* arg) {
+	Pipeline* pipe = ((StageArg*) arg)->pipe; int id = ((StageArg*) arg)->id; long idx; struct timespec since;
+	for (;;) {
+		wait_pop(&pipe->jobs, &idx);
+		if (idx < 0)
+			break;
+		clock_gettime(CLOCK_MONOTONIC, &since);
+		if (!do_slot(&pipe->slots[idx]))
+			__sync_lock_test_and_set(&pipe->failed, 1);
+		pipe->busy[id] += seconds_since(&since);
+		wait_push(&pipe->done, idx);
+	}
+	return NULL;
+}
+
+/**
+ * pipeline_writer - the thread of the writing stage - takes slots with results off the done queue, writes the
+ * results in the order of the input and hands the slots back to the reader, until all the boards read are written.
+ * @param
+ * arg - the Pipeline
+ * @return
+ * NULL
+ */
+void* pipeline_writer(void* arg) {
+	Pipeline* pipe = arg; long next = 0; long idx; BatchSlot* slot; struct timespec since;
+	for (;;) {
+		if (queue_pop(&pipe->done, &idx)) {
+			clock_gettime(CLOCK_MONOTONIC, &since);
+			pipe->done_depths += queue_depth(&pipe->done) + 1;
+			pipe->pending[pipe->slots[idx].seq % pipe->nslots] = idx;
+			while ((idx = pipe->pending[next % pipe->nslots]) >= 0) { /*write all the results that are in order*/
+				slot = &pipe->slots[idx];
+				fputs(slot->out ? slot->out : "error\n", stdout);
+				pipe->pending[next % pipe->nslots] = -1;
+				next++;
+				wait_push(&pipe->free_slots, idx);
+			}
+			pipe->write_secs += seconds_since(&since);
+		}
+		else if (__sync_fetch_and_add(&pipe->read_done, 0) && next == __sync_fetch_and_add(&pipe->total, 0))
+			break;
+		else
+			sched_yield();
+	}
+	clock_gettime(CLOCK_MONOTONIC, &since);
+	fflush(stdout);
+	pipe->write_secs += seconds_since(&since);
+	return NULL;
+}
+
+/**
+ * free_pipeline - frees the slots, their boards and the queues of a pipeline.
+ * @param
+ * pipe - the pipeline
+ */
+void free_pipeline(Pipeline* pipe) {
+	int i;
+	if (pipe->slots) {
+		for (i = 0; i < pipe->nslots; i++) {
+			free_board(&pipe->slots[i].board);
+			free(pipe->slots[i].out);
+		}
+	}
+	free(pipe->slots);
+	free(pipe->pending);
+	free(pipe->busy);
+	free_queue(&pipe->free_slots);
+	free_queue(&pipe->jobs);
+	free_queue(&pipe->done);
+}
+
+/**
+ * init_pipeline - allocates the slots and the queues of a pipeline. all the slots start in the free_slots queue.
+ * @param
+ * pipe - the pipeline
+ * workers - number of worker threads
+ * @return
+ * 1 - on success
+ * 0 - if memory allocation failed
+ */
+int init_pipeline(Pipeline* pipe, int workers) {
+	int i; int ok;
+	pipe->nslots = SLOTS_PER_WORKER*workers;
+	pipe->slots = malloc(pipe->nslots*sizeof(BatchSlot));
+	pipe->pending = malloc(pipe->nslots*sizeof(long));
+	pipe->busy = calloc(workers, sizeof(double));
+	ok = init_queue(&pipe->free_slots, pipe->nslots);
+	ok = init_queue(&pipe->jobs, pipe->nslots + workers) && ok; /*room for the -1 of every worker*/
+	ok = init_queue(&pipe->done, pipe->nslots) && ok;
+	if (!ok || !pipe->slots || !pipe->pending || !pipe->busy) {
+		free(pipe->slots);
+		pipe->slots = NULL;
+		free_pipeline(pipe);
+		return 0;
+	}
+	for (i = 0; i < pipe->nslots; i++) {
+		pipe->slots[i].board = NULL;
+		pipe->slots[i].out = NULL;
+		pipe->slots[i].out_cap = 0;
+		pipe->pending[i] = -1;
+		queue_push(&pipe->free_slots, i);
+	}
+	pipe->total = 0;
+	pipe->read_done = 0;
+	pipe->failed = 0;
+	pipe->write_secs = 0;
+	pipe->done_depths = 0;
+	return 1;
+}
+
+/**
+ * run_pipeline - does the batch operation on all the boards of the input in three stages that run at the same time:
+ * the calling thread reads the boards, the worker threads solve them, and a writer thread writes their results in
+ * the order of the input (see pipeline_worker, pipeline_writer). the stages pass boards to each other through
+ * bounded lock-free queues of slots - the reader waits for a free slot when the workers or the writer fall behind, so
+ * at most SLOTS_PER_WORKER boards per worker are in memory. at the end of the input the reader queues -1 for every
+ * worker, and the writer stops after the last board read is written. the busy time of every stage and the depths of
+ * the queues are written to the standard error at the end.
+ * @param
+ * rd - the reader of the input
+ * workers - number of worker threads
+ * boards - pointer to the number of boards read, set by the function
+ * @return
+ * 1 - on success
+ * 0 - if the solver failed on a board
+ * -1 - if the pipeline could not be started (no board was read)
+ */
+int run_pipeline(TokenReader* rd, int workers, long* boards) {
+	Pipeline pipe; StageArg* args; pthread_t* tids; pthread_t writer; int started = 0; int i; long idx; int count_hid;
+	BatchSlot* slot; double read_secs = 0; double solve_secs = 0; double jobs_depths = 0; struct timespec since;
+	args = malloc(workers*sizeof(StageArg));
+	tids = malloc(workers*sizeof(pthread_t));
+	if (!args || !tids || !init_pipeline(&pipe, workers)) {
+		free(args);
+		free(tids);
+		return -1;
+	}
+	if (pthread_create(&writer, NULL, pipeline_writer, &pipe) == 0) {
+		for (started = 0; started < workers; started++) {
+			args[started].pipe = &pipe;
+			args[started].id = started;
+			if (pthread_create(&tids[started], NULL, pipeline_worker, &args[started]) != 0)
+				break;
+		}
+		if (started == 0) { /*no one to solve the boards, stop the writer*/
+			__sync_lock_test_and_set(&pipe.read_done, 1);
+			pthread_join(writer, NULL);
+		}
+	}
+	*boards = 0;
+	if (started > 0) {
+		set_count_threads(1); /*the boards are counted at the same time instead*/
+		for (;;) {
+			wait_pop(&pipe.free_slots, &idx);
+			slot = &pipe.slots[idx];
+			clock_gettime(CLOCK_MONOTONIC, &since);
+			slot->res = read_board(rd, &slot->board, &slot->m, &slot->n, &count_hid, 0, NULL);
+			read_secs += seconds_since(&since);
+			if (slot->res == 0)
+				break;
+			slot->seq = (*boards)++;
+			jobs_depths += queue_depth(&pipe.jobs) + 1;
+			wait_push(&pipe.jobs, idx);
+		}
+		__sync_fetch_and_add(&pipe.total, *boards);
+		__sync_fetch_and_add(&pipe.read_done, 1); /*after the total is set, for the writer*/
+		for (i = 0; i < started; i++)
+			wait_push(&pipe.jobs, -1);
+		for (i = 0; i < started; i++) {
+			pthread_join(tids[i], NULL);
+			solve_secs += pipe.busy[i];
+		}
+		pthread_join(writer, NULL);
+		fprintf(stderr, "Pipeline:\n");
+		print_stage_stats("read", 1, *boards, read_secs);
+		print_stage_stats("solve", started, *boards, solve_secs);
+		print_stage_stats("write", 1, *boards, pipe.write_secs);
+		print_queue_stats("jobs", *boards ? jobs_depths / *boards : 0.0, pipe.jobs.max_depth);
+		print_queue_stats("done", *boards ? pipe.done_depths / *boards : 0.0, pipe.done.max_depth);
+	}
+	free(args);
+	free(tids);
+	free_pipeline(&pipe);
+	return started > 0 ? !pipe.failed : -1;
+}
+
+/**
+ * run_sequential - does the batch operation on all the boards of the input one after the other, in the calling thread.
+ * the board is reused as long as the boards are of the same size.
+ * @param
+ * rd - the reader of the input
+ * boards - pointer to the number of boards read, set by the function
+ * @return
+ * 1 - on success
+ * 0 - if the solver failed on a board or memory allocation failed
+ */
+int run_sequential(TokenReader* rd, long* boards) {
+	BatchSlot slot; int count_hid; int ok = 1;
+	slot.board = NULL;
+	slot.out = NULL;
+	slot.out_cap = 0;
+	*boards = 0;
+	while ((slot.res = read_board(rd, &slot.board, &slot.m, &slot.n, &count_hid, 0, NULL)) != 0) {
+		(*boards)++;
+		if (do_slot(&slot))
+			fputs(slot.out, stdout);
+		else {
+			fputs("error\n", stdout);
+			ok = 0;
+		}
+	}
+	fflush(stdout);
+	free_board(&slot.board);
+	free(slot.out);
+	return ok;
+}
+
+/**
+ * run_batch - reads the boards of the batch input, does the batch operation on each of them and writes one line of
+ * result for every board, in the order of the input (see batch_board), or "invalid" for a board that can't be read.
+ * a file is mapped to memory as a whole (see map_file), the standard input is read a part at a time. with more than
+ * one worker (see set_batch_workers) the boards are read, solved and written by a pipeline of threads (see
+ * run_pipeline), then counting the solutions of a board uses one thread. the Gurobi engine is not thread safe, and
+ * with it the boards are solved one after the other. the number of boards and the rate of solving them are written
+ * to the standard error at the end.
+ * @return
+ * 0 - if all the boards were read and done
+ * 1 - otherwise
+ */
+int run_batch() {
+	TokenReader rd; FILE* fp = NULL; int mapped = 0; int ok = -1; long boards = 0; struct timespec since; double secs;
+	int workers = batch_workers > 0 ? batch_workers : online_cores();
+	setvbuf(stdout, out_buf, _IOFBF, OUT_BUF); /*results are written in blocks, not line by line*/
+	rd.fp = NULL;
+	rd.buf = NULL;
+	rd.len = rd.pos = rd.cap = 0;
+	rd.eof = 0;
+	if (batch_input != NULL) {
+		if (!(fp = fopen(batch_input, "r"))) {
+			print_file_err_solve();
+			return 1;
+		}
+		rd.buf = map_file(fp, &rd.len, &mapped);
+		rd.cap = rd.len;
+		rd.eof = 1;
+	}
+	else
+		rd.fp = stdin;
+	if (get_solver_engine() == GUROBI_ENGINE)
+		workers = 1;
+	clock_gettime(CLOCK_MONOTONIC, &since);
+	if (workers > 1)
+		ok = run_pipeline(&rd, workers, &boards);
+	if (ok == -1)
+		ok = run_sequential(&rd, &boards);
+	secs = seconds_since(&since); /*the results written are included*/
+	ok = ok && !ferror(fp != NULL ? fp : stdin);
+	print_batch_stats(boards, secs);
+	if (mapped)
+		munmap(rd.buf, rd.len);
+	else
+		free(rd.buf);
+	if (fp != NULL)
+		fclose(fp);
+	free_solver();
+	return !ok;
+}
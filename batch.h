@@ -0,0 +1,30 @@
+/**
+* batch Summary:
+* Runs the solver over a corpus of boards without the interactive game - the boards are read one after the other from
+* a file or from the standard input, and one line of result is written for each of them.
+*
+* supports the following functions:
+*
+* set_batch_op - selects the operation done on every board - solve, validate or count, and turns on batch mode.
+* set_batch_input - sets the file the boards are read from.
+* set_count_cap - sets the number of solutions after which counting stops.
+* set_batch_workers - sets the number of threads that solve the boards.
+* batch_mode - checks whether batch mode was selected.
+* run_batch - reads all the boards and writes a result for each of them.
+* format_grid - writes the values of a board in one line.
+*
+*/
+
+extern int set_batch_op(char* op);
+
+extern void set_batch_input(char* path);
+
+extern void set_count_cap(long cap);
+
+extern void set_batch_workers(int workers);
+
+extern int batch_mode();
+
+extern int run_batch();
+
+extern void format_grid(char* out, int* grid, int N);
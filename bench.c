@@ -0,0 +1,396 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "structs.h"
+#include "struct_functions.h"
+#include "parser.h"
+#include "game.h"
+#include "solver.h"
+#include "dlx.h"
+#include "generator.h"
+#define BENCH_SEED 20240601UL /*seed of the corpus, so every run benchmarks the same boards*/
+#define COUNT_CAP 1000 /*solutions counted by num_solutions before it stops*/
+#define BACKTRACK_MAX_N 9 /*largest boards ex_backtrack, which counts every solution, runs on*/
+#define GENERATE_MAX_N 12 /*largest boards the generate loop runs on*/
+#define BENCH_FILE "sudoku-bench.tmp" /*file of the parse_file and save benchmarks*/
+
+/*
+ * a harness of micro-benchmarks of the hot paths of the game and the solvers, built by "make bench" (not part of the
+ * game). every benchmark runs one operation on one board of a fixed corpus - boards of 2x2, 3x3, 3x4, 4x4 and 5x5
+ * blocks with 30%, 50% and 70% of their cells filled, made from the same seed on every run - until it ran for the
+ * minimal time, and reports the time per operation, the operations per second and the allocations per operation.
+ * allocations are counted by wrapping malloc, calloc and realloc at link time (-Wl,--wrap), so they include the
+ * allocations of the program's own code, not of the C library. the results are printed as a table and written as
+ * JSON, to compare releases - with "--json -" the JSON goes to the standard output, and the table to the standard
+ * error.
+ */
+
+long bench_allocs = 0; /*number of calls to malloc, calloc and realloc*/
+double min_secs = 0.2; /*least time every benchmark runs for*/
+int corpus_m[] = {2, 3, 3, 4, 5};
+int corpus_n[] = {2, 3, 4, 4, 5};
+double corpus_fill[] = {0.3, 0.5, 0.7};
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+	__sync_fetch_and_add(&bench_allocs, 1);
+	return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+	__sync_fetch_and_add(&bench_allocs, 1);
+	return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+	__sync_fetch_and_add(&bench_allocs, 1);
+	return __real_realloc(ptr, size);
+}
+
+/**
+ * Type represents a running benchmark - the operations done, the time they took and the allocations they made.
+ */
+typedef struct bench {
+	long ops;
+	double secs;
+	long allocs;
+	struct timespec since; /*start of the operation being timed*/
+	long allocs_since;
+} Bench;
+
+/**
+ * Type represents the state shared by the benchmarks - the board of the corpus benchmarked, a copy of it to work on,
+ * and the game state the commands take.
+ */
+typedef struct bench_state {
+	Board* corpus; /*the board of the corpus, never changed*/
+	Board* board; /*copy of it for the operations that change the board*/
+	int m; int n;
+	int count_hid;
+	MODE mode;
+	MoveList* curr_move;
+	FILE* report; /*the table of the results*/
+	FILE* json; /*the results as JSON*/
+	int first; /*set until the first result was written to json*/
+} BenchState;
+
+/**
+ * start_op - starts timing an operation.
+ * @param
+ * b - the benchmark
+ */
+void start_op(Bench* b) {
+	b->allocs_since = bench_allocs;
+	clock_gettime(CLOCK_MONOTONIC, &b->since);
+}
+
+/**
+ * end_op - stops timing an operation, and adds it to the benchmark.
+ * @param
+ * b - the benchmark
+ * ops - number of operations done since start_op
+ */
+void end_op(Bench* b, long ops) {
+	b->secs += seconds_since(&b->since);
+	b->allocs += bench_allocs - b->allocs_since;
+	b->ops += ops;
+}
+
+/**
+ * copy_board - puts the values of the board of the corpus in the working board, and rebuilds its index.
+ * @param
+ * st - the state
+ */
+void copy_board(BenchState* st) {
+	int idx; int N = st->corpus->N;
+	st->count_hid = 0;
+	for (idx = 0; idx < N*N; idx++) {
+		NUM_AT(st->board,idx) = NUM_AT(st->corpus,idx);
+		STAT_AT(st->board,idx) = NUM_AT(st->corpus,idx) ? FIXED : HIDDEN;
+		if (NUM_AT(st->corpus,idx) == 0)
+			st->count_hid++;
+	}
+	build_board_index(st->board);
+}
+
+/**
+ * report - prints the result of a benchmark, and writes it to the JSON file.
+ * @param
+ * st - the state
+ * name - name of the benchmark
+ * b - the benchmark
+ */
+void report(BenchState* st, char* name, Bench* b) {
+	double ns = b->ops ? 1e9*b->secs/b->ops : 0; double per_sec = b->secs > 0 ? b->ops/b->secs : 0;
+	double allocs = b->ops ? (double) b->allocs/b->ops : 0; int N = st->m*st->n; int clues = N*N - st->count_hid;
+	fprintf(st->report, "%-16s %dx%d %4d/%-4d %10ld %14.1f %14.1f %10.2f\n", name, st->m, st->n, clues, N*N, b->ops, ns,
+			per_sec, allocs);
+	fprintf(st->json, "%s\n    {\"name\": \"%s\", \"block\": \"%dx%d\", \"clues\": %d, \"cells\": %d, \"ops\": %ld, "
+			"\"ns_per_op\": %.1f, \"ops_per_sec\": %.1f, \"allocs_per_op\": %.2f}", st->first ? "" : ",", name, st->m,
+			st->n, clues, N*N, b->ops, ns, per_sec, allocs);
+	st->first = 0;
+}
+
+/**
+ * bench_validate_dig - times validate_dig on every digit of every cell of the board, by the constraint index.
+ * @param
+ * st - the state
+ */
+void bench_validate_dig(BenchState* st) {
+	Bench b; int N = st->m*st->n; int row; int col; int dig; int valid = 0;
+	memset(&b, 0, sizeof(Bench));
+	copy_board(st);
+	while (b.secs < min_secs) {
+		start_op(&b);
+		for (row = 0; row < N; row++)
+			for (col = 0; col < N; col++)
+				for (dig = 1; dig <= N; dig++)
+					valid += validate_dig(dig, row, col, st->m, st->n, N, st->board, 0, 1);
+		end_op(&b, (long) N*N*N);
+	}
+	if (valid < 0) /*keeps the calls*/
+		printf("%d\n", valid);
+	report(st, "validate_dig", &b);
+}
+
+/**
+ * bench_autofill - times autofill on the board, which is put back before every run (not timed).
+ * @param
+ * st - the state
+ */
+void bench_autofill(BenchState* st) {
+	Bench b;
+	memset(&b, 0, sizeof(Bench));
+	while (b.secs < min_secs) {
+		copy_board(st);
+		st->mode = SOLVE;
+		start_op(&b);
+		autofill(st->board, st->m, st->n, &st->mode, &st->count_hid, &st->curr_move, 1);
+		end_op(&b, 1);
+		empty_move_list(&st->curr_move);
+	}
+	copy_board(st);
+	report(st, "autofill", &b);
+}
+
+/**
+ * bench_num_solutions - times counting the solutions of the board with Dancing Links, up to COUNT_CAP of them.
+ * @param
+ * st - the state
+ */
+void bench_num_solutions(BenchState* st) {
+	Bench b;
+	memset(&b, 0, sizeof(Bench));
+	copy_board(st);
+	while (b.secs < min_secs) {
+		start_op(&b);
+		count_solutions(st->board, COUNT_CAP, NULL);
+		end_op(&b, 1);
+	}
+	report(st, "num_solutions", &b);
+}
+
+#ifndef NO_GUROBI
+/**
+ * bench_ilp - times solving the board with Gurobi (see ilp_grid), with the model the build selects: the reduced model
+ * of the board's open candidates, built on every call, or with -DILP_FULL_MODEL the full model kept between calls.
+ * the name of the result tells which, so the JSON of the two builds can be compared.
+ * @param
+ * st - the state
+ */
+void bench_ilp(BenchState* st) {
+	Bench b; int N = st->m*st->n;
+	int* grid = malloc(N*N*sizeof(int));
+	if (!grid)
+		return;
+	memset(&b, 0, sizeof(Bench));
+	copy_board(st);
+	while (b.secs < min_secs) {
+		start_op(&b);
+		if (ilp_grid(st->board, st->m, st->n, grid) != 1)
+			break;
+		end_op(&b, 1);
+	}
+	free(grid);
+#ifdef ILP_FULL_MODEL
+	report(st, "ilp_full", &b);
+#else
+	report(st, "ilp_reduced", &b);
+#endif
+}
+#endif
+
+/**
+ * bench_ex_backtrack - times counting all the solutions of the board with the exhaustive backtracking of ex_backtrack,
+ * on boards of BACKTRACK_MAX_N cells in a row at most and fewer than COUNT_CAP solutions.
+ * @param
+ * st - the state
+ */
+void bench_ex_backtrack(BenchState* st) {
+	Bench b;
+	copy_board(st);
+	if (st->m*st->n > BACKTRACK_MAX_N || count_solutions(st->board, COUNT_CAP, NULL) >= COUNT_CAP)
+		return;
+	memset(&b, 0, sizeof(Bench));
+	while (b.secs < min_secs) {
+		start_op(&b);
+		ex_backtrack(st->board, st->n, st->m, st->count_hid);
+		end_op(&b, 1);
+	}
+	report(st, "ex_backtrack", &b);
+}
+
+/**
+ * bench_generate - times the generate loop - a random full grid, then clues removed while the solution stays unique
+ * (see make_puzzle) - down to the number of clues of the board, on boards of GENERATE_MAX_N cells in a row at most.
+ * @param
+ * st - the state
+ */
+void bench_generate(BenchState* st) {
+	Bench b; int N = st->m*st->n; int idx; unsigned long rng = BENCH_SEED;
+	if (N > GENERATE_MAX_N)
+		return;
+	memset(&b, 0, sizeof(Bench));
+	copy_board(st);
+	while (b.secs < min_secs) {
+		for (idx = 0; idx < N*N; idx++)
+			NUM_AT(st->board,idx) = 0;
+		build_board_index(st->board);
+		start_op(&b);
+		make_puzzle(st->board, N*N - st->count_hid, &rng);
+		end_op(&b, 1);
+	}
+	copy_board(st);
+	report(st, "generate", &b);
+}
+
+/**
+ * bench_save - times save of the board to BENCH_FILE.
+ * @param
+ * st - the state
+ */
+void bench_save(BenchState* st) {
+	Bench b;
+	memset(&b, 0, sizeof(Bench));
+	copy_board(st);
+	while (b.secs < min_secs) {
+		start_op(&b);
+		save(st->board, BENCH_FILE, st->m, st->n, SOLVE);
+		end_op(&b, 1);
+	}
+	report(st, "save", &b);
+}
+
+/**
+ * bench_parse_file - times parse_file of the board, saved to BENCH_FILE by bench_save. the board is allocated by
+ * parse_file, so the allocations include it.
+ * @param
+ * st - the state
+ */
+void bench_parse_file(BenchState* st) {
+	Bench b; FILE* fp; int m; int n; int count_hid; Board* loaded = NULL;
+	memset(&b, 0, sizeof(Bench));
+	while (b.secs < min_secs && (fp = fopen(BENCH_FILE, "r")) != NULL) {
+		start_op(&b);
+		parse_file(fp, &loaded, &m, &n, &count_hid, SOLVE, 1);
+		end_op(&b, 1);
+		fclose(fp);
+	}
+	free_board(&loaded);
+	report(st, "parse_file", &b);
+}
+
+/**
+ * make_corpus_board - makes a board of the corpus - a random full grid with cells emptied in a random order, without
+ * keeping the solution unique, until the given part of the cells is left.
+ * @param
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * fill - part of the cells left filled
+ * rng - state of the random generator
+ * @return
+ * the board, NULL if memory allocation failed
+ */
+Board* make_corpus_board(int m, int n, double fill, unsigned long* rng) {
+	Board* board = create_empty_board(m, n); int N = m*n;
+	if (board == NULL)
+		return NULL;
+	if (fill_random_grid(board, rng) != 1 || remove_clues(board, (int) (fill*N*N), rng, 0) < 0) {
+		free_board(&board);
+		return NULL;
+	}
+	return board;
+}
+
+int main(int argc, char** argv) {
+	BenchState st; int i; int s; int f; unsigned long rng = BENCH_SEED; char* json_path = "bench.json"; int ok = 1;
+	FILE* out; /*the standard output, before it is discarded*/
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--json") && i+1 < argc)
+			json_path = argv[++i];
+		else if (!strcmp(argv[i], "--min-time") && i+1 < argc)
+			min_secs = atof(argv[++i]);
+		else {
+			fprintf(stderr, "Usage: %s [--json FILE|-] [--min-time SECONDS]\n", argv[0]);
+			return 1;
+		}
+	}
+	memset(&st, 0, sizeof(BenchState));
+	out = fdopen(dup(fileno(stdout)), "w");
+	st.report = strcmp(json_path, "-") ? out : stderr;
+	st.json = strcmp(json_path, "-") ? fopen(json_path, "w") : out;
+	if (out == NULL || st.json == NULL || !freopen("/dev/null", "w", stdout)) {
+		fprintf(stderr, "Error: could not open the output of the benchmarks\n");
+		return 1;
+	}
+	set_solver_engine("native");
+	set_count_threads(1); /*one operation at a time*/
+	st.curr_move = create_move_list(NULL, 0);
+	st.first = 1;
+	fprintf(st.json, "{\n  \"min_time\": %.3f,\n  \"results\": [", min_secs);
+	fprintf(st.report, "%-16s %-3s %9s %10s %14s %14s %10s\n", "benchmark", "blk", "clues", "ops", "ns/op", "ops/s",
+			"allocs/op");
+	for (s = 0; ok && s < (int) (sizeof(corpus_m)/sizeof(corpus_m[0])); s++) {
+		for (f = 0; ok && f < (int) (sizeof(corpus_fill)/sizeof(corpus_fill[0])); f++) {
+			st.m = corpus_m[s];
+			st.n = corpus_n[s];
+			st.corpus = make_corpus_board(st.m, st.n, corpus_fill[f], &rng);
+			st.board = create_empty_board(st.m, st.n);
+			if (!(ok = st.corpus != NULL && st.board != NULL))
+				break;
+			bench_validate_dig(&st);
+			bench_autofill(&st);
+			bench_num_solutions(&st);
+#ifndef NO_GUROBI
+			bench_ilp(&st);
+#endif
+			bench_ex_backtrack(&st);
+			bench_generate(&st);
+			bench_save(&st);
+			bench_parse_file(&st);
+			free_board(&st.corpus);
+			free_board(&st.board);
+			st.corpus = st.board = NULL; /*free_board leaves the pointers*/
+			fflush(st.report);
+		}
+	}
+	fprintf(st.json, "\n  ]\n}\n");
+	if (st.json != out)
+		fclose(st.json);
+	remove(BENCH_FILE);
+	free_board(&st.corpus);
+	free_board(&st.board);
+	empty_move_list(&st.curr_move);
+	free_move_pool();
+	free_solver();
+	fclose(out);
+	if (!ok)
+		fprintf(stderr, "Error: could not make the corpus of the benchmarks\n");
+	return !ok;
+}
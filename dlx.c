@@ -0,0 +1,499 @@
+#include <stdlib.h>
+#include "structs.h"
+#include "dlx.h"
+#include "pool.h"
+
+
+/*BUILDING THE MATRIX*/
+
+/**
+ * cell_columns - computes the four constraint columns satisfied by placing dig in cell <row,col>.
+ * columns are numbered from 1, column 0 is the root.
+ * @param
+ * board - game's board
+ * row - row of the cell
+ * col - column of the cell
+ * dig - the digit placed
+ * cols - array of 4 to fill with the columns
+ */
+void cell_columns(Board* board, int row, int col, int dig, int* cols) {
+	int N = board->N;
+	cols[0] = 1 + row*N + col; /*cell is filled*/
+	cols[1] = 1 + N*N + row*N + dig-1; /*dig appears in row*/
+	cols[2] = 1 + 2*N*N + col*N + dig-1; /*dig appears in column*/
+	cols[3] = 1 + 3*N*N + (BLOCK_UNIT(board,row,col)-2*N)*N + dig-1; /*dig appears in block*/
+}
+
+/**
+ * append_node - adds a node at the bottom of a column, as part of a row.
+ * @param
+ * dlx - the matrix
+ * node - index of the new node
+ * c - header of the column
+ * first - first node of the row, or node itself if it is the first one
+ * row - index of the row
+ */
+void append_node(DLXMatrix* dlx, int node, int c, int first, int row) {
+	dlx->col[node] = c;
+	dlx->node_row[node] = row;
+	dlx->up[node] = dlx->up[c];
+	dlx->down[node] = c;
+	dlx->down[dlx->up[c]] = node;
+	dlx->up[c] = node;
+	dlx->size[c]++;
+	dlx->left[node] = dlx->left[first];
+	dlx->right[node] = first;
+	dlx->right[dlx->left[first]] = node;
+	dlx->left[first] = node;
+}
+
+/**
+ * create_dlx - builds the exact cover matrix of a board, according to the cells' num values.
+ * columns satisfied by filled cells are left out of the matrix, and a row is added for every digit that may be placed in
+ * each empty cell. if two filled cells satisfy the same column, the matrix is marked infeasible.
+ * @param
+ * board - game's board
+ * @return
+ * pointer to the matrix, NULL if memory allocation failed
+ */
+DLXMatrix* create_dlx(Board* board) {
+	int N = board->N; int ncols = 4*N*N; int max_nodes;
+	int row; int col; int dig; int k; int c; int node; int first; int cols[4];
+	char* given;
+	DLXMatrix* dlx = calloc(1,sizeof(DLXMatrix));
+	if (!dlx)
+		return NULL;
+	max_nodes = 1 + ncols + 4*N*N*N;
+	dlx->ncols = ncols;
+	dlx->left = malloc(max_nodes*sizeof(int));
+	dlx->right = malloc(max_nodes*sizeof(int));
+	dlx->up = malloc(max_nodes*sizeof(int));
+	dlx->down = malloc(max_nodes*sizeof(int));
+	dlx->col = malloc(max_nodes*sizeof(int));
+	dlx->node_row = malloc(max_nodes*sizeof(int));
+	dlx->size = calloc(ncols+1,sizeof(int));
+	dlx->row_cell = malloc(N*N*N*sizeof(int));
+	dlx->row_dig = malloc(N*N*N*sizeof(int));
+	dlx->row_node = malloc(N*N*N*sizeof(int));
+	given = calloc(ncols+1,sizeof(char));
+	if (!dlx->left || !dlx->right || !dlx->up || !dlx->down || !dlx->col || !dlx->node_row || !dlx->size
+			|| !dlx->row_cell || !dlx->row_dig || !dlx->row_node || !given) {
+		free(given);
+		destroy_dlx(dlx);
+		return NULL;
+	}
+	/*mark the columns already satisfied by filled cells*/
+	for (row = 0; row < N; row++) {
+		for (col = 0; col < N; col++) {
+			if ((dig = CELL_NUM(board,row,col)) != 0) {
+				cell_columns(board,row,col,dig,cols);
+				for (k = 0; k < 4; k++) {
+					if (given[cols[k]])
+						dlx->infeasible = 1;
+					given[cols[k]] = 1;
+				}
+			}
+		}
+	}
+	/*link the headers of the remaining columns to the root*/
+	dlx->left[0] = dlx->right[0] = 0;
+	for (c = 1; c <= ncols; c++) {
+		dlx->up[c] = dlx->down[c] = c;
+		dlx->col[c] = c;
+		if (!given[c]) {
+			dlx->left[c] = dlx->left[0];
+			dlx->right[c] = 0;
+			dlx->right[dlx->left[0]] = c;
+			dlx->left[0] = c;
+		}
+	}
+	/*add a row for every digit that may be placed in an empty cell*/
+	node = ncols + 1;
+	for (row = 0; row < N; row++) {
+		for (col = 0; col < N; col++) {
+			if (CELL_NUM(board,row,col) != 0)
+				continue;
+			for (dig = 1; dig <= N; dig++) {
+				cell_columns(board,row,col,dig,cols);
+				if (given[cols[1]] || given[cols[2]] || given[cols[3]])
+					continue;
+				dlx->row_cell[dlx->nrows] = CELL_IDX(board,row,col);
+				dlx->row_dig[dlx->nrows] = dig;
+				dlx->row_node[dlx->nrows] = node;
+				first = node;
+				dlx->left[first] = dlx->right[first] = first;
+				for (k = 0; k < 4; k++)
+					append_node(dlx,node++,cols[k],first,dlx->nrows);
+				dlx->nrows++;
+			}
+		}
+	}
+	free(given);
+	return dlx;
+}
+
+/**
+ * destroy_dlx - frees the exact cover matrix.
+ * @param
+ * dlx - the matrix
+ */
+void destroy_dlx(DLXMatrix* dlx) {
+	if (!dlx)
+		return;
+	free(dlx->left);
+	free(dlx->right);
+	free(dlx->up);
+	free(dlx->down);
+	free(dlx->col);
+	free(dlx->node_row);
+	free(dlx->size);
+	free(dlx->row_cell);
+	free(dlx->row_dig);
+	free(dlx->row_node);
+	free(dlx);
+}
+
+
+/*SEARCH*/
+
+/**
+ * cover - removes a column from the header list, and removes all rows of the column from the other columns.
+ * @param
+ * dlx - the matrix
+ * c - header of the column
+ */
+void cover(DLXMatrix* dlx, int c) {
+	int i; int j;
+	dlx->right[dlx->left[c]] = dlx->right[c];
+	dlx->left[dlx->right[c]] = dlx->left[c];
+	for (i = dlx->down[c]; i != c; i = dlx->down[i]) {
+		for (j = dlx->right[i]; j != i; j = dlx->right[j]) {
+			dlx->down[dlx->up[j]] = dlx->down[j];
+			dlx->up[dlx->down[j]] = dlx->up[j];
+			dlx->size[dlx->col[j]]--;
+		}
+	}
+}
+
+/**
+ * uncover - undoes cover, in the reverse order.
+ * @param
+ * dlx - the matrix
+ * c - header of the column
+ */
+void uncover(DLXMatrix* dlx, int c) {
+	int i; int j;
+	for (i = dlx->up[c]; i != c; i = dlx->up[i]) {
+		for (j = dlx->left[i]; j != i; j = dlx->left[j]) {
+			dlx->size[dlx->col[j]]++;
+			dlx->down[dlx->up[j]] = j;
+			dlx->up[dlx->down[j]] = j;
+		}
+	}
+	dlx->right[dlx->left[c]] = c;
+	dlx->left[dlx->right[c]] = c;
+}
+
+/**
+ * choose_column - chooses the column with the fewest rows left (the S heuristic).
+ * @param
+ * dlx - the matrix
+ * @return
+ * header of the chosen column
+ */
+int choose_column(DLXMatrix* dlx) {
+	int c; int best = dlx->right[0];
+	for (c = dlx->right[best]; c != 0; c = dlx->right[c]) {
+		if (dlx->size[c] < dlx->size[best]) {
+			best = c;
+			if (dlx->size[best] <= 1)
+				break;
+		}
+	}
+	return best;
+}
+
+/**
+ * search - recursively counts the exact covers of the matrix, adding them to dlx->count.
+ * stops as soon as dlx->cap solutions were found (if cap is set), leaving the matrix as it was.
+ * @param
+ * dlx - the matrix
+ */
+void search(DLXMatrix* dlx) {
+	int c; int r; int j;
+	dlx->nodes++;
+	if (dlx->right[0] == 0) { /*all constraints satisfied - found a solution*/
+		dlx->count++;
+		return;
+	}
+	c = choose_column(dlx);
+	if (dlx->size[c] == 0) /*constraint can't be satisfied, backtrack*/
+		return;
+	cover(dlx,c);
+	for (r = dlx->down[c]; r != c; r = dlx->down[r]) {
+		for (j = dlx->right[r]; j != r; j = dlx->right[j])
+			cover(dlx,dlx->col[j]);
+		search(dlx);
+		for (j = dlx->left[r]; j != r; j = dlx->left[j])
+			uncover(dlx,dlx->col[j]);
+		if (dlx->cap > 0 && dlx->count >= dlx->cap)
+			break;
+	}
+	uncover(dlx,c);
+}
+
+/**
+ * dlx_count - counts the solutions of the matrix.
+ * @param
+ * dlx - the matrix
+ * cap - stop after cap solutions were found, 0 for no cap
+ * @return
+ * number of solutions found (at most cap, if cap is set). the number of search nodes is kept in dlx->nodes.
+ */
+long dlx_count(DLXMatrix* dlx, long cap) {
+	dlx->count = 0;
+	dlx->nodes = 0;
+	dlx->cap = cap;
+	if (!dlx->infeasible)
+		search(dlx);
+	return dlx->count;
+}
+
+
+/*PARALLEL COUNTING*/
+
+int dlx_threads = 0; /*number of threads used for counting, 0 for all online cores*/
+int dlx_split_depth = 3; /*depth at which the search tree is split into independent subproblems*/
+
+/**
+ * Type represents the subproblems of a split search - for each task, the rows chosen on the way down to it.
+ */
+typedef struct split_tasks {
+	int depth; /*number of rows kept for each task, unused places hold -1*/
+	int* rows; /*rows[task*depth+k] - k-th row chosen for task*/
+	int ntasks;
+	int size; /*number of tasks there is room for*/
+	long nodes; /*number of search nodes visited while splitting*/
+	int failed; /*set if memory allocation failed*/
+} SplitTasks;
+
+/**
+ * Type represents the shared state of a parallel count.
+ */
+typedef struct par_count {
+	Board* board;
+	SplitTasks* split;
+	DLXMatrix** mats; /*matrix of each worker, built on the worker's first task*/
+	long cap;
+	long total; /*solutions found by all workers, updated atomically*/
+	long nodes; /*search nodes visited by all workers, updated atomically*/
+	int failed; /*set if a worker could not build its matrix*/
+} ParCount;
+
+/**
+ * set_count_threads - sets the number of threads used for counting solutions.
+ * @param
+ * threads - number of threads, 0 for all online cores
+ */
+void set_count_threads(int threads) {
+	dlx_threads = threads;
+}
+
+/**
+ * set_split_depth - sets the depth at which the search tree is split into subproblems for the threads.
+ * @param
+ * depth - the depth, at least 1
+ */
+void set_split_depth(int depth) {
+	dlx_split_depth = depth;
+}
+
+/**
+ * select_row - adds a row to the partial solution by covering all of its columns.
+ * @param
+ * dlx - the matrix
+ * row - the row
+ */
+void select_row(DLXMatrix* dlx, int row) {
+	int node = dlx->row_node[row]; int j;
+	cover(dlx,dlx->col[node]);
+	for (j = dlx->right[node]; j != node; j = dlx->right[j])
+		cover(dlx,dlx->col[j]);
+}
+
+/**
+ * unselect_row - undoes select_row, in the reverse order.
+ * @param
+ * dlx - the matrix
+ * row - the row
+ */
+void unselect_row(DLXMatrix* dlx, int row) {
+	int node = dlx->row_node[row]; int j;
+	for (j = dlx->left[node]; j != node; j = dlx->left[j])
+		uncover(dlx,dlx->col[j]);
+	uncover(dlx,dlx->col[node]);
+}
+
+/**
+ * add_task - records the rows chosen so far as a new subproblem.
+ * @param
+ * split - the subproblems
+ * prefix - the rows chosen
+ * k - number of rows chosen
+ */
+void add_task(SplitTasks* split, int* prefix, int k) {
+	int i; int* rows;
+	if (split->ntasks == split->size) {
+		rows = realloc(split->rows, 2*split->size*split->depth*sizeof(int));
+		if (!rows) {
+			split->failed = 1;
+			return;
+		}
+		split->rows = rows;
+		split->size *= 2;
+	}
+	for (i = 0; i < split->depth; i++)
+		split->rows[split->ntasks*split->depth+i] = i < k ? prefix[i] : -1;
+	split->ntasks++;
+}
+
+/**
+ * collect_tasks - walks the search tree of the matrix down to split->depth, and records each node reached at that depth
+ * (or each solution reached before it) as a subproblem. dead ends are left out.
+ * @param
+ * dlx - the matrix
+ * split - the subproblems
+ * prefix - the rows chosen on the way to the current node
+ * k - depth of the current node
+ */
+void collect_tasks(DLXMatrix* dlx, SplitTasks* split, int* prefix, int k) {
+	int c; int r; int j;
+	if (k == split->depth || dlx->right[0] == 0) {
+		add_task(split, prefix, k);
+		return;
+	}
+	split->nodes++;
+	c = choose_column(dlx);
+	if (dlx->size[c] == 0)
+		return;
+	cover(dlx,c);
+	for (r = dlx->down[c]; r != c && !split->failed; r = dlx->down[r]) {
+		prefix[k] = dlx->node_row[r];
+		for (j = dlx->right[r]; j != r; j = dlx->right[j])
+			cover(dlx,dlx->col[j]);
+		collect_tasks(dlx, split, prefix, k+1);
+		for (j = dlx->left[r]; j != r; j = dlx->left[j])
+			uncover(dlx,dlx->col[j]);
+	}
+	uncover(dlx,c);
+}
+
+/**
+ * count_task - counts the solutions of one subproblem on the matrix of the running worker, and adds them to the total.
+ * tasks are skipped once the total reached the cap.
+ * @param
+ * arg - the ParCount of the count
+ * task - index of the subproblem
+ * worker - index of the running worker
+ */
+void count_task(void* arg, int task, int worker) {
+	ParCount* par = (ParCount*) arg;
+	int depth = par->split->depth; int* rows = par->split->rows + task*depth; int k;
+	long found; DLXMatrix* dlx;
+	if (par->cap > 0 && __sync_fetch_and_add(&par->total, 0) >= par->cap)
+		return;
+	if (par->mats[worker] == NULL) {
+		par->mats[worker] = create_dlx(par->board);
+		if (par->mats[worker] == NULL) {
+			par->failed = 1;
+			return;
+		}
+	}
+	dlx = par->mats[worker];
+	for (k = 0; k < depth && rows[k] >= 0; k++)
+		select_row(dlx, rows[k]);
+	found = dlx_count(dlx, par->cap);
+	while (k > 0)
+		unselect_row(dlx, rows[--k]);
+	__sync_fetch_and_add(&par->total, found);
+	__sync_fetch_and_add(&par->nodes, dlx->nodes);
+}
+
+/**
+ * count_parallel - counts the solutions of a matrix by splitting its search tree into subproblems at dlx_split_depth,
+ * and counting them on a work-stealing pool of threads. each worker searches its own copy of the matrix.
+ * the result doesn't depend on the number of threads or the order in which the subproblems are counted.
+ * @param
+ * board - game's board
+ * dlx - the matrix of the board, used for splitting
+ * cap - stop after cap solutions were found, 0 for no cap
+ * threads - number of threads
+ * nodes - pointer to variable to hold the number of search nodes visited, may be NULL
+ * @return
+ * number of solutions (at most cap, if cap is set), -1 if memory allocation failed
+ */
+long count_parallel(Board* board, DLXMatrix* dlx, long cap, int threads, long* nodes) {
+	SplitTasks split; ParCount par; int* prefix; int i; long res;
+	split.depth = dlx_split_depth < 1 ? 1 : dlx_split_depth;
+	split.size = 64;
+	split.ntasks = 0;
+	split.nodes = 0;
+	split.failed = 0;
+	split.rows = malloc(split.size*split.depth*sizeof(int));
+	prefix = malloc(split.depth*sizeof(int));
+	par.mats = calloc(threads,sizeof(DLXMatrix*));
+	if (!split.rows || !prefix || !par.mats) {
+		free(split.rows);
+		free(prefix);
+		free(par.mats);
+		return -1;
+	}
+	if (!dlx->infeasible)
+		collect_tasks(dlx, &split, prefix, 0);
+	par.board = board;
+	par.split = &split;
+	par.cap = cap;
+	par.total = 0;
+	par.nodes = split.nodes;
+	par.failed = split.failed;
+	if (!par.failed && !run_pool(threads, split.ntasks, count_task, &par))
+		par.failed = 1;
+	for (i = 0; i < threads; i++)
+		destroy_dlx(par.mats[i]);
+	free(par.mats);
+	free(split.rows);
+	free(prefix);
+	if (nodes)
+		*nodes = par.nodes;
+	if (par.failed)
+		return -1;
+	res = par.total;
+	return (cap > 0 && res > cap) ? cap : res;
+}
+
+/**
+ * count_solutions - counts the solutions of a board using Dancing Links, on dlx_threads threads.
+ * @param
+ * board - game's board
+ * cap - stop after cap solutions were found, 0 for no cap
+ * nodes - pointer to variable to hold the number of search nodes visited, may be NULL
+ * @return
+ * number of solutions (at most cap, if cap is set), -1 if memory allocation failed
+ */
+long count_solutions(Board* board, long cap, long* nodes) {
+	long res;
+	int threads = dlx_threads > 0 ? dlx_threads : online_cores();
+	DLXMatrix* dlx = create_dlx(board);
+	if (!dlx)
+		return -1;
+	if (threads > 1) {
+		res = count_parallel(board, dlx, cap, threads, nodes);
+		destroy_dlx(dlx);
+		return res;
+	}
+	res = dlx_count(dlx, cap);
+	if (nodes)
+		*nodes = dlx->nodes;
+	destroy_dlx(dlx);
+	return res;
+}
@@ -0,0 +1,25 @@
+/**
+* dlx Summary:
+* Counts the solutions of a board with Dancing Links (Knuth's Algorithm X) over the exact cover formulation of Sudoku -
+* every cell holds one value, and every digit appears once in each row, column and block (the same constraints ilp uses).
+*
+* supports the following functions:
+*
+* create_dlx - builds the exact cover matrix of a board.
+* destroy_dlx - frees the exact cover matrix.
+* dlx_count - counts the solutions of the matrix, optionally stopping after a given number of solutions.
+* count_solutions - counts the solutions of a board using the functions above.
+*
+*/
+
+extern DLXMatrix* create_dlx(Board* board);
+
+extern void destroy_dlx(DLXMatrix* dlx);
+
+extern long dlx_count(DLXMatrix* dlx, long cap);
+
+extern long count_solutions(Board* board, long cap, long* nodes);
+
+extern void set_count_threads(int threads);
+
+extern void set_split_depth(int depth);
@@ -6,8 +6,10 @@
 #include "structs.h"
 #include "struct_functions.h"
 #include "solver.h"
+#include "dlx.h"
 #include "main_aux.h"
 #include "parser.h"
+#include "generator.h"
 #define DEF_ROWS 3
 #define DEF_COLS 3
 
@@ -21,8 +23,8 @@
  * col - column of cell
  * mode - game's mode
  */
-void write_num (FILE* fp, Num*** board, int row, int col, MODE mode) {
-	int dig = board[row][col]->num;
+void write_num (FILE* fp, Board* board, int row, int col, MODE mode) {
+	int dig = CELL_NUM(board,row,col);
 	if (mode == EDIT) {
 		if ( dig != 0)
 			fprintf(fp,"%d.",dig);
@@ -30,7 +32,7 @@ void write_num (FILE* fp, Num*** board, int row, int col, MODE mode) {
 			fprintf(fp, "0");
 	}
 	else if (mode == SOLVE) {
-		if (board[row][col]->status == FIXED)
+		if (CELL_STAT(board,row,col) == FIXED)
 			fprintf(fp,"%d.",dig);
 		else
 			fprintf(fp,"%d",dig);
@@ -38,86 +40,129 @@ void write_num (FILE* fp, Num*** board, int row, int col, MODE mode) {
 }
 
 /**
- * print_num prints the numbers according to their status (HIDDEN|SHOWN|FIXED|ERRONEOUS) and according to game's mode.
- *
+ * Type represents the last board printed - the buffer it was rendered into, and the glyph of every cell (see
+ * cell_glyph) which print_changes compares the board to.
+ */
+typedef struct frame {
+	char* text; /*the board is rendered here and written at once*/
+	size_t cap;
+	int* glyphs; /*N*N glyphs of the board printed last, NULL if there is none*/
+	int N;
+} Frame;
+
+Frame frame = {NULL, 0, NULL, 0};
+int diff_boards = 0; /*whether set, undo and redo print only the cells that changed*/
+
+/**
+ * set_diff_boards - sets whether set, undo and redo print only the cells that changed instead of the whole board.
+ * @param
+ * on - 1 to print the changed cells, 0 to print the board
+ */
+void set_diff_boards(int on) {
+	diff_boards = on;
+}
+
+/**
+ * cell_glyph - tells how a cell is printed, according to its status (HIDDEN|SHOWN|FIXED|ERRONEOUS) and the game's mode.
  * @param
- * n - pointer to struct Num, which represents the number that appears in the cell.
+ * board - the Sudoku board
+ * idx - index of the cell
  * mode - game's mode
- * mark_errors - indicates whether to mark erros
+ * mark_errors - indicates whether to mark errors
+ * @return
+ * 4*number + mark - mark is 0 for none, 1 for '.' (fixed) and 2 for '*' (erroneous). 0 for an empty cell.
  */
-void print_num (Num* n, MODE mode, int mark_errors) {
-	STAT stat = n -> status;
-	int number = n -> num;
-	switch (stat) {
-	case HIDDEN: /*value is 0*/
-		printf("    ");
-		break;
-	case SHOWN:
-		printf(" %2d ", number);
-		break;
+int cell_glyph(Board* board, int idx, MODE mode, int mark_errors) {
+	int glyph = 4*NUM_AT(board,idx); /*0 for a HIDDEN cell*/
+	switch (STAT_AT(board,idx)) {
 	case FIXED:
 		if (mode == SOLVE)
-			printf(" %2d.", number);
-		else
-			printf(" %2d ", number);
+			glyph += 1;
 		break;
 	case ERRONEOUS:
 		if (mode == EDIT || mark_errors)
-			printf(" %2d*", number);
-		else
-			printf(" %2d ", number);
+			glyph += 2;
+		break;
+	default:
+		break;
 	}
+	return glyph;
 }
 
-
 /**
-* clear_board - function clears cells from the board by setting them to 0 and changing their status to HIDDEN.
-* @params:
-* board - the Sudoku board
-* N - number of digits in one block
-* to_clear - number of cells to clear
-*/
-void clear_board(Num*** board, int N, int to_clear){
-	int row = 0;
-	int col = 0;
-	int i; int j;
-	int count = 0;
-	if (to_clear == N*N) {
-		for (i = 0; i < N; i++) {
-			for (j = 0; j < N; j++) {
-				board[i][j]-> num = 0;
-				board[i][j]-> status = HIDDEN;
-			}
-		}
+ * render_cell - writes a cell as it is shown on the board - 4 spaces when it is empty, " %2d" and its mark (or a space)
+ * otherwise.
+ * @param
+ * out - the buffer
+ * glyph - the glyph of the cell (see cell_glyph)
+ * @return
+ * pointer past the written characters
+ */
+char* render_cell(char* out, int glyph) {
+	int number = glyph / 4;
+	if (glyph == 0) {
+		memcpy(out, "    ", 4);
+		return out + 4;
 	}
-	else {	
-		while (count < to_clear) {
-			col = rand() % N;
-			row = rand() % N;
-			if (board[row][col]->status != HIDDEN) {
-				board[row][col]-> num = 0;
-				board[row][col]->status = HIDDEN;
-				count++;
-			}
-		}
+	if (number < 100) {
+		out[0] = ' ';
+		out[1] = number < 10 ? ' ' : '0' + number / 10;
+		out[2] = '0' + number % 10;
+		out += 3;
 	}
+	else
+		out += sprintf(out, " %d", number);
+	*out++ = " .*"[glyph % 4];
+	return out;
 }
 
+/**
+ * render_dashes - writes a line of 4N+m+1 dashes.
+ * @param
+ * out - the buffer
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * @return
+ * pointer past the written line
+ */
+char* render_dashes(char* out, int m, int n) {
+	memset(out, '-', 4*n*m+m+1);
+	out += 4*n*m+m+1;
+	*out++ = '\n';
+	return out;
+}
 
 /**
- * print_dashes - prints 4N+m+1 dashes.
- *
+ * reserve_frame - makes room for the rendering of a board in frame.text, and for the glyphs of its cells.
+ * @param
+ * N - number of cells in one block/row/col
+ * len - number of characters needed
+ * @return
+ * 1 - on success
+ * 0 - if memory allocation failed
  */
-void print_dashes(int m, int n) {
-	int i;
-	for (i=0; i<4*n*m+m+1; i++) {
-		printf("-");
+int reserve_frame(int N, size_t len) {
+	char* text; int* glyphs;
+	if (frame.cap < len) {
+		text = realloc(frame.text, len);
+		if (!text)
+			return 0;
+		frame.text = text;
+		frame.cap = len;
 	}
-	printf("\n");
+	if (frame.N != N || frame.glyphs == NULL) {
+		glyphs = realloc(frame.glyphs, N*N*sizeof(int));
+		if (!glyphs)
+			return 0;
+		frame.glyphs = glyphs;
+		frame.N = N;
+	}
+	return 1;
 }
 
 /**
- * print_board prints the Sudoku board by using print_dashes and print_num functions.
+ * print_board prints the Sudoku board. the board is rendered into one buffer, which is kept between calls, and
+ * written with one fwrite - not a call to printf for every cell.
  *
  * @param 
  * m - number of rows in one block
@@ -130,232 +175,182 @@ void print_dashes(int m, int n) {
  * 3 - otherwise
  * 
  */
-int print_board(Num*** board, int m, int n, MODE mode, int mark_errors) {
-	int row;
-	int col;
+int print_board(Board* board, int m, int n, MODE mode, int mark_errors) {
+	int N = n*m; int row; int col; int idx; int width = 4; int k; char* out;
 	if(mode == INIT){
 		print_invalid();
 		return 3;
 	}
-	for (row = 0; row < n*m; row++){
-		if (row % m == 0){
-			print_dashes(m,n);
-		}
-		for (col = 0; col < n*m; col++) {
+	for (k = N; k >= 100; k /= 10) /*a cell of 3 digits or more is wider*/
+		width++;
+	if (!reserve_frame(N, (size_t) (N+n+1)*(N*width+m+2))) {
+		printf("Error: print_board has failed\n");
+		return 3;
+	}
+	out = frame.text;
+	for (row = 0; row < N; row++){
+		if (row % m == 0)
+			out = render_dashes(out,m,n);
+		for (col = 0; col < N; col++) {
 			if (col % n == 0)
-				printf("%s","|");
-			print_num(board[row][col], mode, mark_errors);
+				*out++ = '|';
+			idx = CELL_IDX(board,row,col);
+			frame.glyphs[idx] = cell_glyph(board,idx,mode,mark_errors);
+			out = render_cell(out,frame.glyphs[idx]);
 		}
-		printf("%c\n",'|');
+		*out++ = '|';
+		*out++ = '\n';
 	}
-	print_dashes(m,n);
+	out = render_dashes(out,m,n);
+	fwrite(frame.text, 1, out - frame.text, stdout);
 	return 2;
 }
 
 /**
-* fill_k_cells - fill k random cells with legal random values
-* @param
-* board - the Sudoku board
-* k - number of cells to choose
-* m - number of rows in one block
-* n - number of columns in one block
-* @return
-* 1 - if k cells were filled with legal values successfully
-* 0 - otherwise
-*/
-int fill_k_cells(Num*** board, int k, int m, int n){
-	int row = 0; int col = 0; int count_filled = 0; int count_checked;
-	int N = n*m;
-	int dig;
-	int* checked_nums;
-	while (count_filled < k){
-		col = rand() % N;
-		row = rand() % N;
-		if(board[row][col]-> num == 0){ /*if the chosen cell is empty */
-			checked_nums = calloc(N,sizeof(int));
-			count_checked = 0;
-			dig = 1 + (rand() % N); /*choose a value*/
-			while (count_checked < N) { /*while there are still values unchecked*/
-				if (checked_nums[dig-1] == 0) { /*if we haven't checked this value*/
-					if (validate_dig(dig,row,col,m,n,N,board,0,1)) {  /*if it's valid, fill it*/
-						board[row][col]-> num = dig;
-						board[row][col]-> status = SHOWN;
-						count_filled++;
-						break; /*cell filled successfully*/
-					}
-					else { /*value is not valid*/
-						checked_nums[dig-1]++;
-						count_checked++;
-					}
-				} /*choose a new value*/
-				dig = 1 + (rand() % N);
-			}
-			if (count_checked == N){ /*found cell with no legal value*/
-				free(checked_nums);
-				return 0;
-			}
-			free(checked_nums);
-		}
-	}
-	return 1;
-}
-
-/**
- * create_empty_board - creates a new empty board of the given size.
+ * print_changes - prints the cells that are shown differently than when the board was last printed, one line each,
+ * instead of the whole board: the column and row of the cell, and its value with its mark ('_' for an empty cell).
+ * the whole board is printed (see print_board) when diff_boards is off, or there is no printed board of this size.
  * @param
+ * board - the Sudoku board
  * m - number of rows in one block
  * n - number of columns in one block
+ * mode - game's mode
+ * mark_errors - indicates whether to mark errors
+ * @return
+ * 2 - if printed sucessfully
+ * 3 - otherwise
  */
-Num*** create_empty_board(int m, int n) {
-	int N = n*m;
-	int i; int j;
-	Num*** board = calloc(N,sizeof(Num**));
-	for (i=0; i<N; i++) {
-		board[i] = calloc(N,sizeof(Num*));
-		for (j = 0; j < N; j++) {
-			board[i][j] = create_num(0);
-		}
-	}
-	return board;
-}
-
-/**
- * parse_row goes through the given row and looks for a number dig.
- * if found, the function validates it. if it's valid, it changes its status to SHOWN.
- * @param
- * dig - the number to search
- * row - given row
- * N - number of rows on board
- * board - the game board
- * m - number of rows in a block
- * n - number of columns in a block
- */
-void parse_row (int dig, int row, int N, Num*** board, int m, int n) {
-	int col;
-	for (col = 0; col < N; col++){
-		if (board[row][col]->num == dig && board[row][col]->status != FIXED) {
-			board[row][col]->num = 0;
-			if (validate_dig(dig,row,col,n,m,n*m, board,0,1))
-				board[row][col]->status = SHOWN;
-			board[row][col]->num = dig;
+int print_changes(Board* board, int m, int n, MODE mode, int mark_errors) {
+	int N = n*m; int idx; int glyph; char* out; char cell[16]; char* start; char* end;
+	if (!diff_boards || frame.glyphs == NULL || frame.N != N || frame.cap < 64)
+		return print_board(board,m,n,mode,mark_errors);
+	out = frame.text;
+	for (idx = 0; idx < N*N; idx++) {
+		glyph = cell_glyph(board,idx,mode,mark_errors);
+		if (glyph == frame.glyphs[idx])
+			continue;
+		frame.glyphs[idx] = glyph;
+		if ((size_t) (out - frame.text) + 64 > frame.cap) { /*no room for another line*/
+			fwrite(frame.text, 1, out - frame.text, stdout);
+			out = frame.text;
 		}
-	}
-}
-
-/**
- * parse_col goes through the given column and looks for a number dig.
- * if found, the function validates it. if it's valid, it changes its status to SHOWN.
- * @param
- * dig - the number to search
- * col - given col
- * N - number of rows on board
- * board - the game board
- * m - number of rows in a block
- * n - number of columns in a block
- */
-void parse_col(int dig, int col, int N, Num*** board, int m, int n) {
-	int row;
-	for (row = 0; row < N; row++){
-		if (board[row][col]->num == dig && board[row][col]->status != FIXED) {
-			board[row][col]->num = 0;
-			if (validate_dig(dig,row,col,m,n,n*m, board,0,1))
-				board[row][col]->status = SHOWN;
-			board[row][col]->num = dig;
+		out += sprintf(out, "Cell %d,%d: ", IDX_COL(board,idx)+1, IDX_ROW(board,idx)+1);
+		if (glyph == 0)
+			*out++ = '_';
+		else { /*the cell as on the board, without its spaces*/
+			start = cell;
+			end = render_cell(cell,glyph);
+			while (*start == ' ')
+				start++;
+			if (end[-1] == ' ')
+				end--;
+			memcpy(out, start, end - start);
+			out += end - start;
 		}
+		*out++ = '\n';
 	}
+	fwrite(frame.text, 1, out - frame.text, stdout);
+	return 2;
 }
 
 /**
- * parse_block goes through the block of the given cell coordinates and looks for a number dig.
- * if found, the function validates the it. if it's valid, it changes its status to SHOWN.
- * @param
- * dig - the number to search
- * row - given row
- * col - given col
- * m - number of rows in a block
- * n - number of columns in a block
- * board - the game board
+ * free_board frees all memory resources
+ *
+ * @param  
+ * board - pointer to the Sudoku board
+ *
  */
-void parse_block(int dig, int row, int col, int m, int n, Num*** board) {
-	int r_start = row - row % m;
-	int c_start = col - col % n;
-	int i; int j;
-	for (i = 0; i < m; i++) {
-		for (j = 0; j < n; j++) {
-			if (board[r_start+i][c_start+j]->num == dig && board[r_start+i][c_start+j]->status != FIXED) {
-				board[r_start+i][c_start+j]->num = 0;
-				if (validate_dig(dig,r_start+i,c_start+j,m,n,n*m, board,0,1)) {
-					board[r_start+i][c_start+j]->status = SHOWN;
-				}
-				board[r_start+i][c_start+j]->num = dig;
-			}
-		}
-	}
-}
+void free_board(Board** board){
+	if (*board == NULL)
+		return;
+#ifdef BOARD_SOA
+	free((*board)->num);
+	free((*board)->alt_num);
+	free((*board)->status);
+#else
+	free((*board)->cells); /*frees all cells*/
+#endif
+	free((*board)->unit_cnt);
+	free((*board)->unit_used);
+	free((*board)->unit_sum);
+	free((*board)->sol);
+	free(*board);
+ }
 
 /**
- * parse_legitimate goes through the row, the column and the block of a given cell, and looks for a number dig.
- * if found, the function validates it. if it's valid, it changes its status to SHOWN.
+ * create_empty_board - creates a new empty board of the given size, with an empty constraint index.
+ * all cells are allocated at once, as one contiguous row-major array.
  * @param
- * row - given row
- * col - given col
- * dig - the number to search
- * board - the game board
- * m - number of rows in a block
- * n - number of columns in a block
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * @return
+ * pointer to the new board, NULL if the size is larger than MAX_N or allocation failed
  */
-void parse_legitimate (int col, int row, int dig, Num*** board, int m, int n) {
-	if (dig != 0) {
-		parse_row (dig,row,n*m,board, m, n);
-		parse_col (dig,col,n*m,board,m,n);
-		parse_block(dig,row,col,m,n,board);
+Board* create_empty_board(int m, int n) {
+	int N; Board* board;
+	if (m < 1 || n < 1 || m > MAX_N / n) /*checked before m*n is computed, so it can't overflow*/
+		return NULL;
+	N = n*m;
+	board = calloc(1,sizeof(Board)); /*all arrays NULL, no cached solution*/
+	if (!board)
+		return NULL;
+	board->m = m;
+	board->n = n;
+	board->N = N;
+	board->words = (N + WORD_BITS - 1) / WORD_BITS;
+	board->unit_cnt = calloc((size_t) 3*N*(N+1),sizeof(int));
+	board->unit_used = calloc((size_t) 3*N*board->words,sizeof(unsigned long));
+	board->unit_sum = calloc((size_t) 3*N*(N+1),sizeof(int));
+#ifdef BOARD_SOA
+	board->num = calloc((size_t) N*N,sizeof(int));
+	board->alt_num = calloc((size_t) N*N,sizeof(int));
+	board->status = calloc((size_t) N*N,sizeof(STAT)); /*HIDDEN == 0*/
+	if (!board->num || !board->alt_num || !board->status || !board->unit_cnt || !board->unit_used || !board->unit_sum) {
+#else
+	board->cells = calloc((size_t) N*N,sizeof(Num)); /*num = alt_num = 0, status = HIDDEN*/
+	if (!board->cells || !board->unit_cnt || !board->unit_used || !board->unit_sum) {
+#endif
+		free_board(&board);
+		return NULL;
 	}
+	return board;
 }
 
-
 /**
-* erroneous_board - checks if the board contains erroneous values
+* erroneous_board - checks if the board contains erroneous values, in O(1) - the erroneous cells are counted by
+* set_cell_num as they change.
 *
 * @param
 * board - the Sudoku board
-* N - number of digits in one block
 * @return
 * 1 - if the board contains erroneous values
 * 0 - otherwise
 *
 */
-int erroneous_board(Num*** board, int N) {
-	int i; int j;
-	for(i=0; i< N; i++){
-		for(j=0; j< N; j++){
-			if(board[i][j]->status == ERRONEOUS){
-				return 1;
-			}
-		}
-	}
-	return 0;
+int erroneous_board(Board* board) {
+	return board->err_cnt > 0;
 }
 
 /**
- * validate - validates that the current state of the board is solvable by calling ilp.
+ * validate - validates that the current state of the board is solvable by finding a solution (see solution_grid).
  * and prints massages according to the returned value.
  * @param
  * board - the Sudoku board
  * m - number of rows in one block
  * n - number of columns in one block
  */
-int validate(Num*** board, int m, int n, MODE mode, int print_msg) {
+int validate(Board* board, int m, int n, MODE mode, int print_msg) {
 	if(mode == INIT){
 		print_invalid();
 		return 3;
 	}
-	if(erroneous_board(board,n*m)){
+	if(erroneous_board(board)){
 		if (!print_msg)
 			return 0;
 		print_contains_error();
 		return 3;
 	}
-	if(ilp(board, m, n, "valid", 0 , 0)){
+	if(solution_grid(board, m, n)){
 		if (print_msg)
 			print_validation_passed();
 		return 2;
@@ -411,8 +406,8 @@ void switch_mode (MODE* mode, int val, MoveList** curr_move) {
  * 3 - an error occured.
  *
  */
-int set (int col,int row,int dig, Num*** board, int m, int n, int* count_hid, MODE* mode, MoveList** curr_move, int mark_errors) {
-	int prev_val; STAT prev_stat; SingleSet* move_step; Move* move = NULL;
+int set (int col,int row,int dig, Board* board, int m, int n, int* count_hid, MODE* mode, MoveList** curr_move, int mark_errors) {
+	int prev_val;
 	/*errors*/
 	if (*mode == INIT){
 		print_invalid();
@@ -422,41 +417,26 @@ int set (int col,int row,int dig, Num*** board, int m, int n, int* count_hid, MO
 		print_invalid_range(n*m, "set");
 		return 3;
 	}
-	if (board[row][col]->status == FIXED) {
+	if (CELL_STAT(board,row,col) == FIXED) {
 		print_fixed();
 		return 3;
 	}
 	/*set the cell*/
-	prev_val = board[row][col]->num;
-	prev_stat = board[row][col]->status;
+	prev_val = CELL_NUM(board,row,col);
 	if (prev_val != dig) { /*if they are the same, board is not changing, and we don't consider it as a move*/
-		if (prev_stat == ERRONEOUS) { /* change cells that are now valid to SHOWN */
-			board[row][col]->num = 0;
-			parse_legitimate(col,row,prev_val,board,m,n);
-		}
-		if (dig == 0) { /*emptying a cell*/
-			board[row][col]->status = HIDDEN;
+		if (dig == 0) /*emptying a cell*/
 			*count_hid+=1;
-		}
-		else {  /*need to mark all new errors*/
-			if (!validate_dig(dig,row,col,m, n,n*m, board, 1,1))
-				board[row][col]->status = ERRONEOUS;
-			else
-				board[row][col]->status = SHOWN;
-		}
 		if (prev_val == 0)
 			*count_hid-=1;
-		board[row][col]->num = dig;
+		set_cell_num(board,row,col,dig); /*also marks the cell and its peers ERRONEOUS, SHOWN or HIDDEN*/
 		/* clear moves beyond current move and add this move */
-		move_step = create_single_set(prev_val,dig,col,row);
-		move = create_move(move_step);
-		empty_move_list_forward((*curr_move)->next);
-		(*curr_move)->next = create_move_list(*curr_move,move);
-		*curr_move = (*curr_move)->next;
+		*curr_move = new_move(*curr_move,1);
+		add_step(*curr_move,prev_val,dig,col,row);
+		end_move(*curr_move,board);
 	}
-	print_board(board ,m, n, *mode, mark_errors);
+	print_changes(board ,m, n, *mode, mark_errors);
 	if (*count_hid == 0 && *mode == SOLVE) {
-		if (validate(board,m,n,*mode,0) == 2) {
+		if (board_solved(board)) { /*a full board without repeated digits, no need to solve it*/
 			printf("Puzzle solved successfully\n");
 			switch_mode(mode,1,curr_move);
 		}
@@ -467,7 +447,7 @@ int set (int col,int row,int dig, Num*** board, int m, int n, int* count_hid, MO
 }
 
 
-/* create_move_from_board - goes through the board and creates a move, according to the function it was called from.
+/* create_move_from_board - goes through the board and adds a new move after the current move, according to the function it was called from.
  * call from generate -  steps are from empty cells to value filled by generate (move contains all cells on board that are not empty)
  * call from autofill - steps are from empty cells to values suggested by autofill saved in alt_num.
  * call from autofill - function moves the value from alt_num to num and clears alt_num
@@ -475,47 +455,45 @@ int set (int col,int row,int dig, Num*** board, int m, int n, int* count_hid, MO
  * board- game's board
  * N - number of cells in one block
  * calling_func - short name of calling function, either "gen" for generate or "auto" for autofill
- * @return
- * pointer to created move.
+ * curr_move - pointer to pointer of current move, set to the new move
  */
-Move* create_move_from_board(Num*** board, int N, char* calling_func) {
-	int i; int j; int new_dig = 0;
-	Move* head_move = create_move(NULL);
-	Move* move = head_move;
+void create_move_from_board(Board* board, int N, char* calling_func, MoveList** curr_move) {
+	int i; int j; int new_dig = 0; int steps = 0;
+	for (i = 0; i < N; i++) { /*count the steps, which are kept in one array*/
+		for (j = 0; j < N; j++) {
+			if ((!strcmp(calling_func,"gen") ? CELL_NUM(board,i,j) : CELL_ALT(board,i,j)) != 0)
+				steps++;
+		}
+	}
+	*curr_move = new_move(*curr_move,steps);
 	for (i = 0; i < N; i++) {
 		for (j = 0; j < N; j++) {
 			if (!strcmp(calling_func,"gen")) /*digit for move is num*/
-				new_dig = board[i][j]->num;
+				new_dig = CELL_NUM(board,i,j);
 			else if (!strcmp(calling_func,"auto")) { /*digit for move is alt_num, clear it and set num*/
-				new_dig = board[i][j]->alt_num;
-				board[i][j]->alt_num = 0;
+				new_dig = CELL_ALT(board,i,j);
+				CELL_ALT(board,i,j) = 0;
 				if (new_dig != 0)
-					board[i][j]->num = new_dig;
-			}
-			if (new_dig != 0 ) { /*create move and add it*/
-				SingleSet* step = create_single_set(0,new_dig,j,i);
-				if (move->change == NULL) { /*first step of move*/
-					move->change = step;
-				}
-				else { /*another node to steps of move*/
-					move->next = create_move(step);
-					move = move->next;
-				}
+					set_cell_num(board,i,j,new_dig);
 			}
+			if (new_dig != 0 ) /*add step to the move*/
+				add_step(*curr_move,0,new_dig,j,i);
 		}
 	}
-	return head_move;
+	end_move(*curr_move,board);
 }
 
 
 /**
- * generate - generates a puzzle by randomly filling x cells with random legal values, running ILP to solve
- * the resulting board, and then clearing all but Y random cells.
+ * generate - generates a puzzle of Y cells with the generator (see make_puzzle): the board is filled with a random
+ * full grid, and its cells are then emptied in a random order while the solution stays unique, until Y are left. when
+ * a unique solution needs more than Y cells, the rest are emptied regardless and a note is printed. nothing is retried,
+ * and the random generator is seedable (see set_gen_seed).
  * @param 
  * board - the Sudoku board
  * m - number of rows in one block
  * n - number of columns in one block
- * x - number of random cells to be filled with random value
+ * x - number of random cells to be filled with random value. kept for the command's syntax - the whole grid is random
  * y - number of random cells to be set as fixed
  *
  * @return
@@ -523,10 +501,8 @@ Move* create_move_from_board(Num*** board, int N, char* calling_func) {
  * 3 - otherwise
  *
  */
-int generate (Num*** board, int m, int n, int x, int y, MODE mode, int* count_hid, MoveList** curr_move) {
-	int j = 0;
-	int N = n*m;
-	Move* head_move; MoveList* move;
+int generate (Board* board, int m, int n, int x, int y, MODE mode, int* count_hid, MoveList** curr_move) {
+	int N = n*m; int clues; int idx; int unique;
 	/*errors*/
 	if(mode != EDIT){
 		print_invalid();
@@ -541,35 +517,54 @@ int generate (Num*** board, int m, int n, int x, int y, MODE mode, int* count_hi
 		return 3;
 	}
 	if (y > 0) { /*otherwise, nothing is actually happening*/
-		while(j<1000){
-			/* X random cells filled with legal random value and solve board using ilp */
-			if (fill_k_cells(board, x, m, n) && ilp(board, m, n, "gen", 0, 0)) { /*on success*/
-				/* Randomly clear N*N-Y cells */
-				clear_board(board, N, N*N-y);
-				*count_hid = N*N-y;
-				print_board(board,m,n,mode,1);
-				/*create a move with all changes from empty to filled cells*/
-				head_move = create_move_from_board(board,n*m, "gen");
-				empty_move_list_forward((*curr_move)->next);
-				move = create_move_list(*curr_move,head_move);
-				(*curr_move)->next = move;
-				*curr_move = (*curr_move)->next;
-				return 2;
-			}
-			/* on failure */
-			j++;
-			clear_board(board, N, N*N);
-		} /*didn't succeed after 1000 iterations*/
-		print_gen_failed();
-		return 3;
+		clues = make_puzzle(board, y, gen_rng());
+		unique = clues == y;
+		if (clues > y) /*no unique puzzle has so few cells*/
+			clues = remove_clues(board, y, gen_rng(), 0);
+		if (clues < 0) {
+			for (idx = 0; idx < N*N; idx++)
+				NUM_AT(board,idx) = 0;
+			build_board_index(board);
+			print_gen_failed();
+			return 3;
+		}
+		*count_hid = N*N-y;
+		print_board(board,m,n,mode,1);
+		if (!unique)
+			print_not_unique();
+		/*create a move with all changes from empty to filled cells*/
+		create_move_from_board(board,n*m,"gen",curr_move);
+		return 2;
 	}
 	print_board(board,m,n,mode,1); /*if nothing happend print board anyway*/
 	return 2;
 }
 
 /**
- * undo - undo the last move.
- * function undoes the move, prints the board, and then prints all the changes, when necessary.
+ * print_move - prints the changes of the cells in a move that was undone or redone.
+ * @param
+ * move - the move
+ * undone - 1 if the move was undone, 0 if it was redone
+ */
+void print_move (MoveList* move, int undone) {
+	int i; int prev_val; int next_val;
+	char prev[10]; char next[10];
+	for (i = 0; i < move->step_cnt; i++) {
+		prev_val = move->steps[i].prev_val;
+		next_val = move->steps[i].new_val;
+		prev_val == 0? sprintf(prev, "_") : sprintf(prev,"%d",prev_val);
+		next_val == 0? sprintf(next, "_") : sprintf(next,"%d",next_val);
+		if (undone)
+			printf("Undo %d,%d: from %s to %s\n",move->steps[i].col+1,move->steps[i].row+1,next,prev);
+		else
+			printf("Redo %d,%d: from %s to %s\n",move->steps[i].col+1,move->steps[i].row+1,prev,next);
+	}
+}
+
+/**
+ * undo - undo the last moves.
+ * function undoes the moves, prints the board, and then prints all the changes, from the last move backwards.
+ * the board is brought to its state before the moves at once (see goto_move), not one step at a time.
  * @param
  * mode - game's mode
  * curr_move - pointer to pointer of current move
@@ -578,74 +573,39 @@ int generate (Num*** board, int m, int n, int x, int y, MODE mode, int* count_hi
  * m - number of rows in one block
  * n - number of columns in one block
  * mark_errors - indicates whether to mark errors on board
- * print_msg - indicates whether to print messages of cells' changes
+ * moves - number of moves to undo, or all the moves there are if they are fewer
  * @return
- * 2 - if move undone successfully
+ * 2 - if moves undone successfully
  * 3 - otherwise
  */
-int undo (MODE mode, MoveList** curr_move, Num*** board, int* count_hid, int m, int n, int mark_errors, int print_msg) {
-	int row; int col; int prev_val; int next_val; Move* step;
-	char prev[10]; char next[10];
+int undo (MODE mode, MoveList** curr_move, Board* board, int* count_hid, int m, int n, int mark_errors, int moves) {
+	MoveList* target = *curr_move; MoveList* node; int i;
 	if (mode == INIT) {
 		print_invalid();
 		return 3;
 	}
-	if ((*curr_move)->head_move == NULL) {
+	if ((*curr_move)->prev == NULL) {
 		print_no_moves_undo();
 		return 3;
 	}
-	step = (*curr_move)->head_move;
-	while (step != NULL) { /*undo all steps in a move*/
-		row = step->change->row;
-		col = step->change->col;
-		prev_val = step->change->prev_val;
-		next_val = step->change->new_val;
-		if (prev_val != next_val) { /*if they are the same, no point of checking and changing*/
-			board[row][col]->num = 0;
-			if (board[row][col]->status == ERRONEOUS) { /* change cells that are now valid to SHOWN */
-				parse_legitimate(col,row,next_val,board,m,n);
-			}
-			/*update cell and change cells that are now wrong to ERRONEOUS*/
-			if (validate_dig(prev_val,row,col,m,n,n*m,board,1,1))
-				board[row][col]->status = SHOWN;
-			else
-				board[row][col]->status = ERRONEOUS;
-			board[row][col]->num = prev_val;
-			/*update num of hidden cells*/
-			if (prev_val == 0) {
-				*count_hid+=1;
-				board[row][col]->status = HIDDEN;
-			}
-			else if (next_val == 0)
-				*count_hid-=1;
-		}
-		step = step->next;
-	}
-	if (print_msg) {
-	/*print board*/
-	print_board(board,m,n,mode,mark_errors);
+	for (i = 0; i < moves && target->prev != NULL; i++)
+		target = target->prev;
+	goto_move(board,*curr_move,target,1,count_hid);
+	/*print board, or the cells that changed*/
+	print_changes(board,m,n,mode,mark_errors);
 	/*print messages*/
-		step = (*curr_move)->head_move;
-		while (step != NULL) {
-			row = step->change->row;
-			col = step->change->col;
-			prev_val = step->change->prev_val;
-			next_val = step->change->new_val;
-			prev_val == 0? sprintf(prev, "_") : sprintf(prev,"%d",prev_val);
-			next_val == 0? sprintf(next, "_") : sprintf(next,"%d",next_val);
-			printf("Undo %d,%d: from %s to %s\n",col+1,row+1,next,prev);
-			step = step->next;
-		}
-	}
+	for (node = *curr_move; node != target; node = node->prev)
+		print_move(node,1);
 	/*update pointer to previous node*/
-	*curr_move = (*curr_move)->prev;
+	*curr_move = target;
 	return 2;
 }
 
 /**
- * redo - redo the last move.
- * function redoes the move, prints the board, and then prints all the changes.
-* @param
+ * redo - redo the next moves.
+ * function redoes the moves, prints the board, and then prints all the changes.
+ * the board is brought to its state after the moves at once (see goto_move), not one step at a time.
+ * @param
  * mode - game's mode
  * curr_move - pointer to pointer of current move
  * board - game's board
@@ -653,72 +613,190 @@ int undo (MODE mode, MoveList** curr_move, Num*** board, int* count_hid, int m,
  * m - number of rows in one block
  * n - number of columns in one block
  * mark_errors - indicates whether to mark errors on board
- * print_msg - indicates whether to print messages of cells' changes
+ * moves - number of moves to redo, or all the moves there are if they are fewer
  * @return
- * 2 - if move redone successfully
+ * 2 - if moves redone successfully
  * 3 - otherwise
  */
-int redo (MODE mode, MoveList** curr_move, Num*** board, int* count_hid, int m, int n, int mark_errors) {
-	int row; int col; int prev_val; int next_val; Move* step;
-	char prev[10]; char next[10];
+int redo (MODE mode, MoveList** curr_move, Board* board, int* count_hid, int m, int n, int mark_errors, int moves) {
+	MoveList* target = *curr_move; MoveList* node; int i;
 	if (mode == INIT) {
 		print_invalid();
 		return 3;
 	}
-	/*update pointer to next node*/
 	if ((*curr_move)->next == NULL) {
 		print_no_moves_redo();
 		return 3;
 	}
-	*curr_move = (*curr_move)->next;
-	step = (*curr_move)->head_move;
-	while (step != NULL) { /*redo all steps in a move*/
-		row = step->change->row;
-		col = step->change->col;
-		prev_val = step->change->prev_val;
-		next_val = step->change->new_val;
-		if (prev_val != next_val) { /*if they are the same, no point of checking and changing*/
-			board[row][col]->num = 0;
-			if (board[row][col]->status == ERRONEOUS) { /* change cells that are now valid to SHOWN */
-				parse_legitimate(col,row,prev_val,board,m,n);
-			} /*update cell and change cells that are now wrong to ERRONEOUS*/
-			if (validate_dig(next_val,row,col,m,n,n*m,board,1,1))
-				board[row][col]->status = SHOWN;
-			else
-				board[row][col]-> status = ERRONEOUS;
-			board[row][col]->num = next_val;
-		/*update num of hidden cells*/
-		if (next_val == 0) {
-			*count_hid+=1;
-			board[row][col]-> status = HIDDEN;
+	for (i = 0; i < moves && target->next != NULL; i++)
+		target = target->next;
+	goto_move(board,*curr_move,target,0,count_hid);
+	/*print board, or the cells that changed*/
+	print_changes(board,m,n,mode,mark_errors);
+	/*print messages*/
+	for (node = (*curr_move)->next; node != target->next; node = node->next)
+		print_move(node,0);
+	/*update pointer to next node*/
+	*curr_move = target;
+	return 2;
+}
+
+
+/**
+ * Type represents the worklist of autofill - a queue of the units (rows, columns and blocks) that may hold a single
+ * since a cell was filled, each queued at most once at a time.
+ */
+typedef struct fill_list {
+	int* units; /*ring of 3N units*/
+	char* queued; /*queued[unit] - set while unit is in the ring*/
+	int head; int count;
+	int* filled; /*indices of the cells filled, in order*/
+	int filled_cnt;
+	unsigned long* cand; /*scratch bitsets*/
+	unsigned long* once;
+	unsigned long* twice;
+} FillList;
+
+/**
+ * queue_unit - adds a unit at the tail of the worklist of autofill, unless it is already queued.
+ * @param
+ * list - the worklist
+ * N - number of cells in one row/col
+ * unit - index of the unit
+ */
+void queue_unit(FillList* list, int N, int unit) {
+	if (list->queued[unit])
+		return;
+	list->queued[unit] = 1;
+	list->units[(list->head + list->count++) % (3*N)] = unit;
+}
+
+/**
+ * fill_single - puts dig in an empty cell that has dig as its only candidate, or as the only place of dig in a unit,
+ * and queues the units that may hold a new single: the cell's own units, where one cell less is empty, and the other
+ * units of the cell's empty peers, which lost dig as a candidate of the peer.
+ * @param
+ * board - game's board
+ * list - the worklist
+ * idx - index of the cell
+ * dig - the digit
+ */
+void fill_single(Board* board, FillList* list, int idx, int dig) {
+	int N = board->N; int row = IDX_ROW(board,idx); int col = IDX_COL(board,idx); int units[3]; int u; int k; int peer;
+	int prow; int pcol;
+	set_cell_num(board,row,col,dig);
+	list->filled[list->filled_cnt++] = idx;
+	units[0] = ROW_UNIT(board,row);
+	units[1] = COL_UNIT(board,col);
+	units[2] = BLOCK_UNIT(board,row,col);
+	for (u = 0; u < 3; u++) {
+		queue_unit(list,N,units[u]);
+		for (k = 0; k < N; k++) {
+			peer = unit_cell(board,units[u],k);
+			if (NUM_AT(board,peer) != 0)
+				continue;
+			prow = IDX_ROW(board,peer);
+			pcol = IDX_COL(board,peer);
+			if (!(UNIT_BITS(board,ROW_UNIT(board,prow))[DIG_WORD(dig)] & DIG_MASK(dig)))
+				queue_unit(list,N,ROW_UNIT(board,prow));
+			if (!(UNIT_BITS(board,COL_UNIT(board,pcol))[DIG_WORD(dig)] & DIG_MASK(dig)))
+				queue_unit(list,N,COL_UNIT(board,pcol));
+			if (!(UNIT_BITS(board,BLOCK_UNIT(board,prow,pcol))[DIG_WORD(dig)] & DIG_MASK(dig)))
+				queue_unit(list,N,BLOCK_UNIT(board,prow,pcol));
 		}
-		else if (prev_val == 0)
-			*count_hid-=1;
+	}
+}
+
+/**
+ * fill_unit - fills the singles of one unit: empty cells with a single candidate (naked singles), then digits that
+ * have a single empty cell in the unit to go to (hidden singles). the candidates come from the constraint index, so
+ * every cell filled is seen by the cells checked after it.
+ * @param
+ * board - game's board
+ * list - the worklist
+ * unit - index of the unit
+ */
+void fill_unit(Board* board, FillList* list, int unit) {
+	int N = board->N; int words = board->words; int k; int w; int idx; int dig;
+	for (w = 0; w < words; w++)
+		list->once[w] = list->twice[w] = 0;
+	for (k = 0; k < N; k++) {
+		idx = unit_cell(board,unit,k);
+		if (NUM_AT(board,idx) != 0)
+			continue;
+		if (cell_candidates(board,IDX_ROW(board,idx),IDX_COL(board,idx),list->cand) == 1)
+			fill_single(board,list,idx,next_dig(list->cand,words,1));
+		else {
+			for (w = 0; w < words; w++) {
+				list->twice[w] |= list->once[w] & list->cand[w];
+				list->once[w] |= list->cand[w];
+			}
 		}
-		step = step->next;
 	}
-	/*print board*/
-	print_board(board,m,n,mode,mark_errors);
-	/*print message*/
-	step = (*curr_move)->head_move;
-	while (step != NULL) {
-		row = step->change->row;
-		col = step->change->col;
-		prev_val = step->change->prev_val;
-		next_val = step->change->new_val;
-		prev_val == 0? sprintf(prev, "_") : sprintf(prev,"%d",prev_val);
-		next_val == 0? sprintf(next, "_") : sprintf(next,"%d",next_val);
-		printf("Redo %d,%d: from %s to %s\n",col+1,row+1,prev,next);
-		step = step->next;
+	for (w = 0; w < words; w++) /*digits of one place, not placed since*/
+		list->once[w] &= ~(list->twice[w] | UNIT_BITS(board,unit)[w]);
+	for (dig = next_dig(list->once,words,1); dig != 0; dig = next_dig(list->once,words,dig+1)) {
+		for (k = 0; k < N; k++) {
+			idx = unit_cell(board,unit,k);
+			if (NUM_AT(board,idx) == 0 && !dig_used(board,dig,IDX_ROW(board,idx),IDX_COL(board,idx))) {
+				fill_single(board,list,idx,dig);
+				break;
+			}
+		}
 	}
-	/*update pointer to next node*/
-	return 2;
 }
 
+/**
+ * fill_singles - fills naked and hidden singles until there are none left. a worklist holds the units to check,
+ * starting with all of them, and a filled cell queues only the units it may have changed (see fill_single), so the
+ * work follows the cells filled instead of rescanning the whole board every round. a round is one pass over the
+ * units queued by the round before it. only digits no peer holds are filled, so no cell becomes erroneous.
+ * @param
+ * board - game's board
+ * list - the worklist, its arrays allocated
+ * @return
+ * number of rounds that filled cells
+ */
+int fill_singles(Board* board, FillList* list) {
+	int N = board->N; int unit; int in_round; int before; int rounds = 0;
+	list->head = list->count = list->filled_cnt = 0;
+	for (unit = 0; unit < 3*N; unit++) {
+		list->queued[unit] = 0;
+		queue_unit(list,N,unit);
+	}
+	while (list->count > 0) {
+		before = list->filled_cnt;
+		for (in_round = list->count; in_round > 0; in_round--) {
+			unit = list->units[list->head];
+			list->head = (list->head+1) % (3*N);
+			list->count--;
+			list->queued[unit] = 0;
+			fill_unit(board,list,unit);
+		}
+		if (list->filled_cnt > before)
+			rounds++;
+	}
+	return rounds;
+}
 
 /**
- * autofill - fills obvious values on board (cells with single legal value).
- * adds the move to the move list.
+ * free_fill_list - frees the arrays of the worklist of autofill.
+ * @param
+ * list - the worklist
+ */
+void free_fill_list(FillList* list) {
+	free(list->units);
+	free(list->queued);
+	free(list->filled);
+	free(list->cand);
+	free(list->once);
+	free(list->twice);
+}
+
+/**
+ * autofill - fills the obvious values of the board until none are left - cells with a single legal value, and values
+ * with a single legal cell in a row, column or block (see fill_singles). all the cells filled make one move, and the
+ * number of cells and rounds it took is printed.
  * @param:
  * board - game's board
  * n - number of colums
@@ -726,57 +804,47 @@ int redo (MODE mode, MoveList** curr_move, Num*** board, int* count_hid, int m,
  * 2 - on success
  * 3 - if an error occured
  */
-int autofill (Num*** board, int m, int n, MODE* mode, int* count_hid, MoveList** curr_move, int mark_errors) {
-	int i; int j; int dig; int N = n*m;
-	int legal_vals; int sol;
-	Move* head_move; MoveList* move = NULL;
+int autofill (Board* board, int m, int n, MODE* mode, int* count_hid, MoveList** curr_move, int mark_errors) {
+	int N = n*m; int i; int idx; int rounds; FillList list;
 	if (*mode != SOLVE) {
 		print_invalid();
 		return 3;
 	}
-	if (erroneous_board(board,N)) {
+	if (erroneous_board(board)) {
 		print_contains_error();
 		return 3;
 	}
-	for (i = 0; i < N; i++) {
-		for (j = 0; j < N; j++) {
-			if (board[i][j]->num == 0) { /*if cell is empty, check for solutions*/
-				legal_vals = 0; sol = 0;
-				for (dig = 1; dig <= N; dig++) {
-					if (validate_dig(dig,i,j,m,n,N,board,0,1)) {
-						legal_vals++;
-						sol = dig;
-					}
-					if (legal_vals > 1) /*more than single solution, move to next cell*/
-						break;
-				}
-				if (legal_vals == 1) { /*autofill cell*/
-					*count_hid-=1;
-					if (validate_dig(sol,i,j,m,n,N,board,1,0))
-						board[i][j]->status = SHOWN;
-					else
-						board[i][j]->status = ERRONEOUS;
-					board[i][j]->alt_num = sol;
-					print_set_cell(j,i,sol);
-				}
-			}
-		}
+	list.units = malloc(3*N*sizeof(int));
+	list.queued = malloc(3*N);
+	list.filled = malloc(N*N*sizeof(int));
+	list.cand = malloc(board->words*sizeof(unsigned long));
+	list.once = malloc(board->words*sizeof(unsigned long));
+	list.twice = malloc(board->words*sizeof(unsigned long));
+	if (!list.units || !list.queued || !list.filled || !list.cand || !list.once || !list.twice) {
+		free_fill_list(&list);
+		print_autofill_failed();
+		return 3;
 	}
-	/*create a new move, remove forward moves, add move to move list and clear alt_nums*/
-	head_move = create_move_from_board(board,N,"auto"); /*also clears alt_nums back to 0*/
-	if (head_move->change!=NULL){
-		empty_move_list_forward((*curr_move)->next);
-		move = create_move_list(*curr_move,head_move);
-		(*curr_move)->next = move;
-		*curr_move = (*curr_move)->next;
+	rounds = fill_singles(board,&list);
+	for (i = 0; i < list.filled_cnt; i++) {
+		idx = list.filled[i];
+		print_set_cell(IDX_COL(board,idx),IDX_ROW(board,idx),NUM_AT(board,idx));
 	}
-	else { /*otherwise, no cell has been changed and no need to make new move*/
-		free (head_move);
+	*count_hid -= list.filled_cnt;
+	if (list.filled_cnt > 0) { /*otherwise, no cell has been changed and no need to make new move*/
+		*curr_move = new_move(*curr_move,list.filled_cnt); /*also removes forward moves*/
+		for (i = 0; i < list.filled_cnt; i++) {
+			idx = list.filled[i];
+			add_step(*curr_move,0,NUM_AT(board,idx),IDX_COL(board,idx),IDX_ROW(board,idx));
+		}
+		end_move(*curr_move,board);
 	}
+	print_autofill_stats(list.filled_cnt,rounds);
+	free_fill_list(&list);
 	print_board(board,m,n,*mode,mark_errors);
 	/*check if reached end of the game*/
 	if (*count_hid == 0) {
-			if (validate(board,m,n,*mode,0) == 2) {
+			if (board_solved(board)) {
 				printf("Puzzle solved successfully\n");
 				switch_mode(mode,1,curr_move);
 			}
@@ -785,7 +853,7 @@ int autofill (Num*** board, int m, int n, MODE* mode, int* count_hid, MoveList**
 }
 
 /**
- * hint - gives a hint to the user by showing a legal value of required cell, according to the ILP solution.
+ * hint - gives a hint to the user by showing a legal value of required cell, according to the solver's solution.
  * @param
  * board - the Sudoku board
  * col - column in which the cell is located
@@ -797,8 +865,8 @@ int autofill (Num*** board, int m, int n, MODE* mode, int* count_hid, MoveList**
  * 2 - on success
  * 3 - if an error occured
  */
-int hint(Num*** board, int col, int row, int m, int n, MODE mode) {
-	int res;
+int hint(Board* board, int col, int row, int m, int n, MODE mode) {
+	int res; int cell;
 	/*errors*/
 	if (mode != SOLVE) {
 		print_invalid();
@@ -808,21 +876,21 @@ int hint(Num*** board, int col, int row, int m, int n, MODE mode) {
 		print_invalid_range(n*m, "hint");
 		return 3;
 	}
-	if (erroneous_board(board,n*m)) {
+	if (erroneous_board(board)) {
 		print_contains_error();
 		return 3;
 	}
-	if (board[row][col]->status == FIXED) {
+	if (CELL_STAT(board,row,col) == FIXED) {
 		print_fixed();
 		return 3;
 	}
-	if (board[row][col]->num != 0) {
+	if (CELL_NUM(board,row,col) != 0) {
 		print_contains_val();
 		return 3;
 	}
 	/*print hint or unsolvable board*/
-	res = ilp(board,m,n,"hint",col,row);
-	if (!res) {
+	cell = CELL_IDX(board,row,col);
+	if (!hint_cells(board,m,n,&cell,1,&res)) {
 		printf("Error: board is unsolvable\n");
 		return 3;
 	}
@@ -832,10 +900,9 @@ int hint(Num*** board, int col, int row, int m, int n, MODE mode) {
 }
 
 /**
- * save - saves the board as a text file to the path inserted by the user.
+ * hint_all - gives a hint for every empty cell of the board, from one solution of the board (see solution_grid).
  * @param
  * board -game's board
- * path - requested path of saving.
  * m - number of rows in one block
  * n- number of columns in one block
  * mode - game's mode.
@@ -843,21 +910,73 @@ int hint(Num*** board, int col, int row, int m, int n, MODE mode) {
  * 2 - on success
  * 3 - if an error occured
  */
-int save (Num*** board, char* path, int m, int n, MODE mode) {
-	FILE* fp; int i; int j; int N = n*m;
+int hint_all (Board* board, int m, int n, MODE mode) {
+	int N = n*m; int idx; int* grid;
 	/*errors*/
-	if (mode == INIT) {
+	if (mode != SOLVE) {
 		print_invalid();
 		return 3;
 	}
-	if (mode == EDIT && erroneous_board(board,n*m)) {
+	if (erroneous_board(board)) {
 		print_contains_error();
 		return 3;
 	}
+	grid = solution_grid(board,m,n);
+	if (!grid) {
+		printf("Error: board is unsolvable\n");
+		return 3;
+	}
+	for (idx = 0; idx < N*N; idx++)
+		if (NUM_AT(board,idx) == 0)
+			print_hint_cell(IDX_COL(board,idx),IDX_ROW(board,idx),grid[idx]);
+	return 2;
+}
+
+/**
+ * save_allowed - checks that the board may be saved in the game's mode, and prints the error if not: there is no
+ * board in INIT mode, and in EDIT mode the board must be free of errors and solvable.
+ * @param
+ * board - game's board
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * mode - game's mode
+ * @return
+ * 1 - if the board may be saved
+ * 0 - otherwise
+ */
+int save_allowed (Board* board, int m, int n, MODE mode) {
+	if (mode == INIT) {
+		print_invalid();
+		return 0;
+	}
+	if (mode == EDIT && erroneous_board(board)) {
+		print_contains_error();
+		return 0;
+	}
 	if (mode == EDIT && validate(board,m,n,mode,0) == 3) {
 		print_err_validation();
-		return 3;
+		return 0;
 	}
+	return 1;
+}
+
+/**
+ * save - saves the board as a text file to the path inserted by the user.
+ * @param
+ * board -game's board
+ * path - requested path of saving.
+ * m - number of rows in one block
+ * n- number of columns in one block
+ * mode - game's mode.
+ * @return
+ * 2 - on success
+ * 3 - if an error occured
+ */
+int save (Board* board, char* path, int m, int n, MODE mode) {
+	FILE* fp; int i; int j; int N = n*m;
+	/*errors*/
+	if (!save_allowed(board,m,n,mode))
+		return 3;
 	fp = fopen (path, "w");
 	if(!fp){
 		print_file_err_save();
@@ -879,6 +998,73 @@ int save (Num*** board, char* path, int m, int n, MODE mode) {
 	return 2;
 }
 
+/**
+ * save_bin - saves the board in the binary board format (see BIN_MAGIC in structs.h) to the path inserted by the user.
+ * the values are packed in cell_bits(N) bits each, and the file is written at once. as with save, in EDIT mode all the
+ * filled cells are saved as fixed. solve and edit tell the binary format from the text format by its magic.
+ * @param
+ * board - game's board
+ * path - requested path of saving.
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * mode - game's mode.
+ * @return
+ * 2 - on success
+ * 3 - if an error occured
+ */
+int save_bin (Board* board, char* path, int m, int n, MODE mode) {
+	FILE* fp; unsigned char* buf; unsigned char* out; unsigned char* fixed_map; int N = n*m; int bits = cell_bits(N);
+	int idx; int has_fixed = 0; size_t len; size_t written; unsigned long acc = 0; int acc_bits = 0;
+	/*errors*/
+	if (!save_allowed(board,m,n,mode))
+		return 3;
+	for (idx = 0; idx < N*N && !has_fixed; idx++)
+		has_fixed = (mode == EDIT) ? NUM_AT(board,idx) != 0 : STAT_AT(board,idx) == FIXED;
+	len = BIN_HEADER + BIN_BYTES((size_t) N*N*bits) + (has_fixed ? BIN_BYTES((size_t) N*N) : 0);
+	buf = calloc(len,1);
+	if (!buf) {
+		printf("Error: save_bin has failed\n");
+		return 3;
+	}
+	/*header*/
+	memcpy(buf, BIN_MAGIC, 4);
+	buf[4] = BIN_VERSION;
+	buf[5] = has_fixed ? BIN_FIXED : 0;
+	buf[6] = m & 0xFF;
+	buf[7] = (m >> 8) & 0xFF;
+	buf[8] = n & 0xFF;
+	buf[9] = (n >> 8) & 0xFF;
+	/*values, then the bitmap of fixed cells*/
+	out = buf + BIN_HEADER;
+	for (idx = 0; idx < N*N; idx++) {
+		acc |= (unsigned long) NUM_AT(board,idx) << acc_bits;
+		for (acc_bits += bits; acc_bits >= 8; acc_bits -= 8) {
+			*out++ = acc & 0xFF;
+			acc >>= 8;
+		}
+	}
+	if (acc_bits > 0)
+		*out++ = acc & 0xFF;
+	fixed_map = out;
+	for (idx = 0; idx < N*N && has_fixed; idx++)
+		if ((mode == EDIT) ? NUM_AT(board,idx) != 0 : STAT_AT(board,idx) == FIXED)
+			fixed_map[idx >> 3] |= 1 << (idx & 7);
+	fp = fopen (path, "wb");
+	if(!fp){
+		free(buf);
+		print_file_err_save();
+		return 3;
+	}
+	written = fwrite(buf, 1, len, fp);
+	free(buf);
+	if (fclose(fp) != 0 || written != len) {
+		print_file_err_save();
+		return 3;
+	}
+	printf("Saved to: %s\n", path);
+	return 2;
+}
+
 /**
  * solve - loads a board from a file provided by the user in SOLVE mode. initializes the undo/redo list.
  * @param
@@ -894,16 +1080,17 @@ int save (Num*** board, char* path, int m, int n, MODE mode) {
  * 2 on success of creating the board.
  * 3 otherwise
  */
-int solve(char* path, Num**** board, MODE* mode, MoveList** curr_move, int* m, int* n, int* count_hid, int mark_errors) {
+int solve(char* path, Board** board, MODE* mode, MoveList** curr_move, int* m, int* n, int* count_hid, int mark_errors) {
 	int res;
 	FILE* fp = fopen (path, "r");
 	if(!fp){
 		print_file_err_solve();
 		return 3;
 	}
-	switch_mode(mode,3,curr_move);
-	res = parse_file(fp, board, m, n, count_hid, *mode, mark_errors);
+	res = parse_file(fp, board, m, n, count_hid, SOLVE, mark_errors);
 	fclose(fp);
+	if (res == 2) /*an invalid file leaves the game as it was*/
+		switch_mode(mode,3,curr_move);
 	return res;
 }
 
@@ -944,40 +1131,20 @@ int change_mark_errors (double x, MODE mode, int* mark_errors) {
  * 2 - if reset was done successfully
  * 3 - otherwise
  */
-int reset (Num*** board, MoveList** curr_move, MODE mode, int* count_hid, int m, int n, int mark_errors) {
+int reset (Board* board, MoveList** curr_move, MODE mode, int* count_hid, int m, int n, int mark_errors) {
 	if (mode == INIT) {
 		print_invalid();
 		return 3;
-	} /*undo move and change pointer to previous move, untill we reach the empty move*/
-	while ((*curr_move)->head_move != NULL) {
-		undo(mode,curr_move,board,count_hid,m,n,0,0);
-	} /*destroy all moves except the empty move*/
-	empty_move_list_forward((*curr_move)->next);
-	(*curr_move)-> next = NULL;
+	} /*bring the board back to the checkpoint of the empty move*/
+	if ((*curr_move)->prev != NULL)
+		goto_move(board,*curr_move,first_move(),1,count_hid);
+	/*destroy all moves except the empty move, in one reset of the move pool*/
+	empty_move_list(curr_move);
 	print_reset();
 	print_board(board,m,n,mode,mark_errors);
 	return 2;
 }
 
-/**
- * free_board frees all memory resources
- *
- * @param  
- * board - pointer to the Sudoku board
- * N - number of cells in row/col
- *
- */
-void free_board(Num**** board, int N){
-	 int i; int j;
-	 for (i = 0; i < N; i++) {
-		for (j = 0; j < N; j++) {
-			destroy_num((*board)[i][j]); /*frees all nums*/
-		}
-		free((*board)[i]); /*frees all cols*/
-	}
-	free(*board); /*frees all rows*/
- }
-
 /**
  * edit - loads a board from a file provided by the user in EDIT mode or creates an empty board with default size.
  * initializes the undo/redo list.
@@ -993,12 +1160,12 @@ void free_board(Num**** board, int N){
  * 2 - if board has been loaded successfully
  * 3 - otherwise
  */
-int edit (char* parsed_command, Num**** board, MODE* mode, MoveList** curr_move, int* m, int* n, int* count_hid) {
+int edit (char* parsed_command, Board** board, MODE* mode, MoveList** curr_move, int* m, int* n, int* count_hid) {
 	FILE* fp; int res;
 	if (parsed_command == NULL){ /* no file path supplied */
 		switch_mode(mode,2,curr_move);
 		if (*board!=NULL) {
-			free_board(board,*n**m);
+			free_board(board);
 			*board = NULL;
 		}
 		*m = DEF_ROWS;
@@ -1013,36 +1180,57 @@ int edit (char* parsed_command, Num**** board, MODE* mode, MoveList** curr_move,
 		print_file_err_edit();
 		return 3;
 	}
-	switch_mode(mode,2,curr_move);
 	/* create game board from File */
-	res = parse_file(fp, board, m, n, count_hid, *mode, 1);
+	res = parse_file(fp, board, m, n, count_hid, EDIT, 1);
 	fclose(fp);
+	if (res == 2)
+		switch_mode(mode,2,curr_move);
 	return res;
 }
 
 /**
- * num_of_solutions - prints how many solutions there are to the current board using ex_backtrack.
+ * num_of_solutions - prints how many solutions there are to the current board.
+ * solutions are counted with Dancing Links (count_solutions), or with the exhaustive backtracking (ex_backtrack) when
+ * compiled with -DCOUNT_BACKTRACK (COUNT_MODEL in the makefile), which is kept for cross-checking.
  * @param
  * board - game's board
  * m - number of rows in one block
  * n - number of columns in one block
  * count_hid - counter of hidden cells on board
  * mode - game's mode
+ * cap - stop counting after cap solutions, 0 to count all of them
  * @return
  * 2 - if check has been successful
  * 3 - otherwise
  */
-int num_of_solutions (Num*** board, int m, int n, int count_hid, MODE mode) {
-	int res;
+int num_of_solutions (Board* board, int m, int n, int count_hid, MODE mode, long cap) {
+	long res;
 	if (mode == INIT) {
 		print_invalid();
 		return 3;
 	}
-	if (erroneous_board(board,n*m)) {
+	if (erroneous_board(board)) {
 		print_contains_error();
 		return 3;
 	}
+#ifdef COUNT_BACKTRACK
 	res = ex_backtrack(board, n, m, count_hid);
+	if (cap > 0 && res > cap)
+		res = cap;
+#else
+	res = count_solutions(board, cap, NULL);
+	(void) count_hid; (void) m; (void) n;
+#endif
+	if (res < 0) {
+		printf("Error: num_solutions has failed\n");
+		return 3;
+	}
+	if (cap > 0 && res == cap) { /*stopped counting, there may be more solutions*/
+		print_num_sols_cap(res);
+		if (res > 1)
+			print_multi_sols();
+		return 2;
+	}
 	print_num_sols(res);
 	if (res == 1)
 		print_good_board();
@@ -1056,15 +1244,17 @@ int num_of_solutions (Num*** board, int m, int n, int count_hid, MODE mode) {
  *
  * @param  
  * board - pointer to the Sudoku board
- * N - number of cells in row/col
  * curr_move - pointer to pointer of current move
  * @return
  * 1.
  */
-int exit_game (Num**** board, int N, MoveList** curr_move) {
+int exit_game (Board** board, MoveList** curr_move) {
 	printf("Exiting...\n");
-	free_board(board, N);
+	free_board(board);
+	free_solver();
 	empty_move_list(curr_move);
-	free(*curr_move); /*freeing the empty node*/
+	free_move_pool(); /*freeing the empty node*/
+	free(frame.text);
+	free(frame.glyphs);
 	return 1;
 }
@@ -0,0 +1,465 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "structs.h"
+#include "struct_functions.h"
+#include "native_solver.h"
+#include "dlx.h"
+#include "game.h"
+#include "parser.h"
+#include "batch.h"
+#include "main_aux.h"
+#include "pool.h"
+#define TASKS_PER_WORKER 8 /*puzzles a worker makes in one round of bulk generation*/
+#define MAX_TRIES 1000 /*puzzles made for every puzzle written, before giving up on the filters*/
+#define GRID_LEN(N) ((N)*(N)*12 + 32) /*longest text of a puzzle - N*N numbers with separators*/
+
+unsigned long gen_state = 0; /*state of the random generator of the generate command*/
+int gen_seeded = 0; /*set once gen_state was seeded, by set_gen_seed or from the clock*/
+unsigned long gen_seed = 0; /*seed of bulk generation*/
+long gen_count = 0; /*number of puzzles to generate in bulk, 0 when not generating*/
+int gen_m = 3; /*dimensions of the blocks of the generated puzzles*/
+int gen_n = 3;
+int gen_clues = 0; /*stop removing clues at this many, 0 to remove all that can be removed*/
+int gen_workers = 0; /*number of threads of bulk generation, 0 for all online cores*/
+int gen_max_clues = 0; /*write only puzzles with at most this many clues, 0 for no limit*/
+long gen_min_nodes = 0; /*write only puzzles the native solver needs this many search nodes or more for*/
+long gen_max_nodes = 0; /*and at most this many, 0 for no limit*/
+char* gen_output = NULL; /*file the puzzles are written to in the format of save, NULL for the standard output*/
+
+/**
+ * set_gen_seed - seeds the random generator of the generate command and of bulk generation, so the same seed gives
+ * the same puzzles.
+ * @param
+ * seed - the seed
+ */
+void set_gen_seed(unsigned long seed) {
+	gen_state = gen_seed = seed;
+	gen_seeded = 1;
+}
+
+/**
+ * gen_rng - returns the random generator of the generate command, seeded from the clock unless set_gen_seed was called.
+ * @return
+ * pointer to the state of the generator
+ */
+unsigned long* gen_rng() {
+	if (!gen_seeded) {
+		gen_state = (unsigned long) time(NULL);
+		gen_seeded = 1;
+	}
+	return &gen_state;
+}
+
+/**
+ * set_gen_count - sets the number of puzzles to generate in bulk, and turns on bulk generation.
+ * @param
+ * count - the number of puzzles
+ */
+void set_gen_count(long count) {
+	gen_count = count;
+}
+
+/**
+ * set_gen_size - sets the dimensions of the blocks of the puzzles generated in bulk.
+ * @param
+ * size - "MxN" - M rows and N columns in one block, such as "3x3" for 9x9 puzzles
+ * @return
+ * 1 - if size is legal
+ * 0 - otherwise
+ */
+int set_gen_size(char* size) {
+	int m; int n; char x; char rest;
+	if (sscanf(size, "%d%c%d%c", &m, &x, &n, &rest) != 3 || x != 'x' || m < 1 || n < 1 || m > MAX_N / n)
+		return 0;
+	gen_m = m;
+	gen_n = n;
+	return 1;
+}
+
+/**
+ * set_gen_clues - sets the number of clues at which removing clues from a puzzle generated in bulk stops.
+ * @param
+ * clues - the number of clues, 0 to remove every clue that can be removed
+ */
+void set_gen_clues(int clues) {
+	gen_clues = clues;
+}
+
+/**
+ * set_gen_workers - sets the number of threads of bulk generation.
+ * @param
+ * workers - the number of threads, 0 for all online cores
+ */
+void set_gen_workers(int workers) {
+	gen_workers = workers;
+}
+
+/**
+ * set_gen_max_clues - sets the largest number of clues of a puzzle written in bulk generation.
+ * @param
+ * clues - the number of clues, 0 for no limit
+ */
+void set_gen_max_clues(int clues) {
+	gen_max_clues = clues;
+}
+
+/**
+ * set_gen_difficulty - sets the range of difficulty of the puzzles written in bulk generation. the difficulty of a
+ * puzzle is the number of search nodes the native solver visits to solve it - 1 when propagating singles solves it,
+ * and more the more it has to guess (see puzzle_difficulty).
+ * @param
+ * range - "MIN" or "MIN-MAX", such as "2-50"
+ * @return
+ * 1 - if range is legal
+ * 0 - otherwise
+ */
+int set_gen_difficulty(char* range) {
+	long lo; long hi = 0; char dash; char rest; int res = sscanf(range, "%ld%c%ld%c", &lo, &dash, &hi, &rest);
+	if ((res != 1 && (res != 3 || dash != '-' || hi < lo)) || lo < 0)
+		return 0;
+	gen_min_nodes = lo;
+	gen_max_nodes = hi;
+	return 1;
+}
+
+/**
+ * set_gen_output - sets the file the puzzles of bulk generation are written to.
+ * @param
+ * path - path of the file, "-" for the standard output
+ */
+void set_gen_output(char* path) {
+	gen_output = strcmp(path,"-") ? path : NULL;
+}
+
+/**
+ * gen_mode - checks whether bulk generation was selected.
+ * @return
+ * 1 - if a number of puzzles was set with set_gen_count
+ * 0 - otherwise
+ */
+int gen_mode() {
+	return gen_count > 0;
+}
+
+/**
+ * fill_random_grid - fills the empty cells of a board with a random solution of it (see random_solve). on an empty
+ * board this is a random full grid. the values are written to the board directly, and its constraint index, statuses
+ * and hash are built once at the end.
+ * @param
+ * board - the board
+ * rng - state of the random generator
+ * @return
+ * 1 - on success
+ * 0 - if the board is unsolvable
+ * -1 - if memory allocation failed
+ */
+int fill_random_grid(Board* board, unsigned long* rng) {
+	int N = board->N; int idx; int res;
+	int* grid = malloc(N*N*sizeof(int));
+	if (!grid)
+		return -1;
+	res = random_solve(board, grid, rng, NULL);
+	if (res == 1) {
+		for (idx = 0; idx < N*N; idx++)
+			NUM_AT(board,idx) = grid[idx];
+		build_board_index(board);
+	}
+	free(grid);
+	return res;
+}
+
+/**
+ * unique_solution - checks whether a board has exactly one solution, with Dancing Links stopping at the second one.
+ * @param
+ * board - the board
+ * @return
+ * 1 - if the board has one solution
+ * 0 - if it has none, or more than one
+ * -1 - if memory allocation failed
+ */
+int unique_solution(Board* board) {
+	long count; DLXMatrix* dlx = create_dlx(board);
+	if (!dlx)
+		return -1;
+	count = dlx_count(dlx, 2);
+	destroy_dlx(dlx);
+	return count == 1;
+}
+
+/**
+ * remove_clues - empties the filled cells of a board in a random order until target cells are left. when check is
+ * set, a cell is emptied only if the board keeps a unique solution (see unique_solution), so fewer cells may be
+ * emptied - the cells left are then a puzzle from which no clue can be removed.
+ * @param
+ * board - the board, with a unique solution when check is set
+ * target - number of filled cells to leave
+ * rng - state of the random generator
+ * check - 1 to keep the solution unique, 0 to empty cells regardless
+ * @return
+ * number of filled cells left, -1 if memory allocation failed
+ */
+int remove_clues(Board* board, int target, unsigned long* rng, int check) {
+	int N = board->N; int i; int j; int idx; int dig; int res; int clues = 0;
+	int* order = malloc(N*N*sizeof(int));
+	if (!order)
+		return -1;
+	for (idx = 0; idx < N*N; idx++) {
+		order[idx] = idx;
+		if (NUM_AT(board,idx) != 0)
+			clues++;
+	}
+	for (i = N*N-1; i > 0; i--) { /*Fisher-Yates shuffle*/
+		j = (int) (next_rand(rng) % (i+1));
+		idx = order[i];
+		order[i] = order[j];
+		order[j] = idx;
+	}
+	for (i = 0; i < N*N && clues > target; i++) {
+		idx = order[i];
+		dig = NUM_AT(board,idx);
+		if (dig == 0)
+			continue;
+		set_cell_num(board, IDX_ROW(board,idx), IDX_COL(board,idx), 0);
+		res = check ? unique_solution(board) : 1;
+		if (res < 0) {
+			free(order);
+			return -1;
+		}
+		if (res == 0) /*the clue is needed*/
+			set_cell_num(board, IDX_ROW(board,idx), IDX_COL(board,idx), dig);
+		else
+			clues--;
+	}
+	free(order);
+	return clues;
+}
+
+/**
+ * make_puzzle - turns an empty board into a random puzzle with a unique solution: fills it with a random full grid
+ * (see fill_random_grid), then empties cells while the solution stays unique (see remove_clues).
+ * @param
+ * board - an empty board
+ * target - number of clues at which to stop emptying cells, 0 to empty every cell that can be emptied
+ * rng - state of the random generator
+ * @return
+ * number of clues of the puzzle, -1 if memory allocation failed
+ */
+int make_puzzle(Board* board, int target, unsigned long* rng) {
+	int res = fill_random_grid(board, rng);
+	if (res != 1)
+		return -1; /*an empty board is always solvable*/
+	return remove_clues(board, target, rng, 1);
+}
+
+/**
+ * puzzle_seed - derives the state of the random generator of one puzzle of bulk generation from the seed and the
+ * puzzle's number, so every puzzle depends only on them.
+ * @param
+ * seed - the seed of bulk generation
+ * k - number of the puzzle
+ * @return
+ * the state of the generator
+ */
+unsigned long puzzle_seed(unsigned long seed, long k) {
+	unsigned long state = (seed ^ ((unsigned long) k * 0x9E3779B9UL)) & 0xFFFFFFFFUL;
+	next_rand(&state); /*mix the bits of close seeds*/
+	next_rand(&state);
+	return state;
+}
+
+/**
+ * puzzle_difficulty - rates how hard a puzzle is by the number of search nodes the native solver visits to solve it.
+ * the solver propagates naked and hidden singles before every guess, so 1 means singles alone solve the puzzle, and
+ * every guess the propagation can't avoid adds nodes.
+ * @param
+ * board - the puzzle
+ * solution - array of N*N for the solver
+ * @return
+ * number of search nodes, -1 if memory allocation failed
+ */
+long puzzle_difficulty(Board* board, int* solution) {
+	long nodes = 0;
+	if (native_solve(board, solution, &nodes) < 0)
+		return -1;
+	return nodes;
+}
+
+/**
+ * format_save - writes the values of a puzzle in the format of save in EDIT mode - "m n" in the first line, then a line
+ * of every row, the clues marked as fixed with a dot and 0 for the empty cells.
+ * @param
+ * out - buffer of GRID_LEN(N) characters
+ * grid - the values of the cells in row-major order, 0 for an empty cell
+ * m - number of rows in one block
+ * n - number of columns in one block
+ */
+void format_save(char* out, int* grid, int m, int n) {
+	int N = m*n; int idx;
+	out += sprintf(out, "%d %d\n", m, n);
+	for (idx = 0; idx < N*N; idx++) {
+		if (grid[idx] != 0)
+			out += sprintf(out, "%d.", grid[idx]);
+		else
+			*out++ = '0';
+		*out++ = (idx % N == N-1) ? '\n' : ' ';
+	}
+	*out = '\0';
+}
+
+/**
+ * Type represents one puzzle of a round of bulk generation, and its text when it passed the filters.
+ */
+typedef struct gen_slot {
+	int res; /*1 - passed the filters, 0 - filtered out, -1 - memory allocation failed*/
+	int clues;
+	long nodes; /*difficulty (see puzzle_difficulty)*/
+	char* out; /*the puzzle, in the format it is written in*/
+} GenSlot;
+
+/**
+ * Type represents a round of bulk generation - the puzzles made in it, and the board and scratch arrays of every
+ * worker.
+ */
+typedef struct gen_round {
+	GenSlot* slots;
+	long first; /*number of the round's first puzzle*/
+	Board** boards; /*boards[w] - board of worker w*/
+	int** grids; /*grids[w] - scratch array of N*N of worker w*/
+} GenRound;
+
+/**
+ * gen_task - makes one puzzle of a round (see make_puzzle), filters it by its number of clues and its difficulty, and
+ * formats it when it passed. runs on the pool's threads - the puzzle's random generator is derived from its number
+ * (see puzzle_seed), so it doesn't depend on the thread.
+ * @param
+ * arg - the round
+ * task - index of the puzzle in the round
+ * worker - index of the worker
+ */
+void gen_task(void* arg, int task, int worker) {
+	GenRound* round = arg; GenSlot* slot = &round->slots[task]; Board* board = round->boards[worker];
+	int* grid = round->grids[worker]; int N = board->N; int idx; unsigned long state;
+	for (idx = 0; idx < N*N; idx++)
+		NUM_AT(board,idx) = 0;
+	build_board_index(board);
+	state = puzzle_seed(gen_seed, round->first + task);
+	slot->res = -1;
+	if ((slot->clues = make_puzzle(board, gen_clues, &state)) < 0 || (slot->nodes = puzzle_difficulty(board, grid)) < 0)
+		return;
+	slot->res = (gen_max_clues == 0 || slot->clues <= gen_max_clues) && slot->nodes >= gen_min_nodes
+			&& (gen_max_nodes == 0 || slot->nodes <= gen_max_nodes);
+	if (!slot->res)
+		return;
+	for (idx = 0; idx < N*N; idx++)
+		grid[idx] = NUM_AT(board,idx);
+	if (gen_output != NULL)
+		format_save(slot->out, grid, gen_m, gen_n);
+	else
+		format_grid(slot->out, grid, N);
+}
+
+/**
+ * free_round - frees the slots, boards and scratch arrays of a round.
+ * @param
+ * round - the round
+ * tasks - number of slots
+ * workers - number of workers
+ */
+void free_round(GenRound* round, int tasks, int workers) {
+	int i;
+	for (i = 0; round->slots && i < tasks; i++)
+		free(round->slots[i].out);
+	for (i = 0; round->boards && i < workers; i++)
+		free_board(&round->boards[i]);
+	for (i = 0; round->grids && i < workers; i++)
+		free(round->grids[i]);
+	free(round->slots);
+	free(round->boards);
+	free(round->grids);
+}
+
+/**
+ * init_round - allocates the slots of a round and a board and a scratch array for every worker.
+ * @param
+ * round - the round
+ * tasks - number of puzzles in a round
+ * workers - number of workers
+ * @return
+ * 1 - on success
+ * 0 - if memory allocation failed
+ */
+int init_round(GenRound* round, int tasks, int workers) {
+	int N = gen_m*gen_n; int i; int ok;
+	round->slots = calloc(tasks, sizeof(GenSlot));
+	round->boards = calloc(workers, sizeof(Board*));
+	round->grids = calloc(workers, sizeof(int*));
+	ok = round->slots && round->boards && round->grids;
+	for (i = 0; ok && i < tasks; i++)
+		ok = (round->slots[i].out = malloc(GRID_LEN(N))) != NULL;
+	for (i = 0; ok && i < workers; i++)
+		ok = (round->boards[i] = create_empty_board(gen_m, gen_n)) && (round->grids[i] = malloc(N*N*sizeof(int)));
+	if (!ok)
+		free_round(round, tasks, workers);
+	return ok;
+}
+
+/**
+ * run_generator - generates the puzzles of bulk generation and writes them, one per line in the one-line format batch
+ * mode reads (see format_grid), or in the format of save when an output file is set (see format_save).
+ * the puzzles are made in rounds by a pool of workers (see gen_task), and every puzzle has its own random generator
+ * (see puzzle_seed), so a seed gives the same puzzles with any number of workers. the first puzzles that pass the
+ * filters of clues and difficulty are written, in order. the number of puzzles, the rate of generating them and
+ * their average clues and difficulty are written to the standard error.
+ * @return
+ * 0 - if all the puzzles were generated
+ * 1 - otherwise
+ */
+int run_generator() {
+	GenRound round; FILE* fp = stdout; long written = 0; long tried = 0; long total_clues = 0; double total_nodes = 0;
+	int failed = 0; int i; int n; struct timespec since; double secs;
+	int workers = gen_workers > 0 ? gen_workers : online_cores(); int tasks = workers*TASKS_PER_WORKER;
+	if (gen_output != NULL && !(fp = fopen(gen_output, "w"))) {
+		print_file_err_save();
+		return 1;
+	}
+	if (!init_round(&round, tasks, workers)) {
+		if (fp != stdout)
+			fclose(fp);
+		print_gen_failed();
+		return 1;
+	}
+	if (!gen_seeded)
+		set_gen_seed((unsigned long) time(NULL));
+	clock_gettime(CLOCK_MONOTONIC, &since);
+	while (written < gen_count && !failed && tried < gen_count*MAX_TRIES) {
+		round.first = tried;
+		n = gen_count-written < workers ? workers : (gen_count-written > tasks ? tasks : (int) (gen_count-written));
+		if (!run_pool(workers, n, gen_task, &round))
+			failed = 1;
+		for (i = 0; i < n && written < gen_count && !failed; i++) { /*in the order of the puzzles*/
+			tried++;
+			if (round.slots[i].res < 0)
+				failed = 1;
+			else if (round.slots[i].res == 1) {
+				written++;
+				total_clues += round.slots[i].clues;
+				total_nodes += round.slots[i].nodes;
+				fputs(round.slots[i].out, fp);
+			}
+		}
+	}
+	fflush(fp);
+	secs = seconds_since(&since);
+	if (written < gen_count || ferror(fp))
+		print_gen_failed();
+	print_gen_stats(written, tried, secs, written > 0 ? (double) total_clues / written : 0.0,
+			written > 0 ? total_nodes / written : 0.0);
+	failed = written < gen_count || ferror(fp);
+	if (fp != stdout)
+		fclose(fp);
+	free_round(&round, tasks, workers);
+	return failed;
+}
@@ -0,0 +1,63 @@
+/**
+* generator Summary:
+* Generates random puzzles with a unique solution - a random full grid is built by the native solver trying candidates
+* in a random order, and clues are then removed in a random order as long as a capped solution count (Dancing Links,
+* stopping at 2) shows the solution stays unique. the random generator is seedable, so a seed gives the same puzzles.
+* Used by the generate command, and to generate puzzles in bulk without the game - on a pool of threads, each puzzle
+* with its own random generator, filtered by number of clues and by difficulty (search nodes of the native solver).
+*
+* supports the following functions:
+*
+* set_gen_seed - seeds the random generator of the generator.
+* gen_rng - returns the random generator of the generate command.
+* set_gen_count - sets the number of puzzles to generate in bulk, and turns on bulk generation.
+* set_gen_size - sets the dimensions of the blocks of the puzzles generated in bulk.
+* set_gen_clues - sets the number of clues at which removing clues stops in bulk generation.
+* set_gen_workers - sets the number of threads of bulk generation.
+* set_gen_max_clues - sets the largest number of clues of a puzzle written in bulk generation.
+* set_gen_difficulty - sets the range of difficulty of the puzzles written in bulk generation.
+* set_gen_output - sets the file the puzzles of bulk generation are written to, in the format of save.
+* gen_mode - checks whether bulk generation was selected.
+* fill_random_grid - fills the empty cells of a board with a random solution of it.
+* unique_solution - checks whether a board has exactly one solution.
+* remove_clues - empties cells of a board in a random order, optionally only while its solution stays unique.
+* make_puzzle - turns an empty board into a random puzzle with a unique solution.
+* puzzle_difficulty - rates how hard a puzzle is by the search nodes the native solver needs for it.
+* format_save - writes the values of a puzzle in the format of save.
+* run_generator - generates the puzzles of bulk generation on a pool of threads and writes the ones that pass the filters.
+*
+*/
+
+extern void set_gen_seed(unsigned long seed);
+
+extern unsigned long* gen_rng();
+
+extern void set_gen_count(long count);
+
+extern int set_gen_size(char* size);
+
+extern void set_gen_clues(int clues);
+
+extern void set_gen_workers(int workers);
+
+extern void set_gen_max_clues(int clues);
+
+extern int set_gen_difficulty(char* range);
+
+extern void set_gen_output(char* path);
+
+extern int gen_mode();
+
+extern int fill_random_grid(Board* board, unsigned long* rng);
+
+extern int unique_solution(Board* board);
+
+extern int remove_clues(Board* board, int target, unsigned long* rng, int check);
+
+extern int make_puzzle(Board* board, int target, unsigned long* rng);
+
+extern long puzzle_difficulty(Board* board, int* solution);
+
+extern void format_save(char* out, int* grid, int m, int n);
+
+extern int run_generator();
@@ -3,19 +3,129 @@
 #include "structs.h"
 #include "parser.h"
 #include "struct_functions.h"
-#include <time.h>
+#include "main_aux.h"
 #include <string.h>
 #include <assert.h>
-int main () {
+#include "dlx.h"
+#include "solver.h"
+#include "batch.h"
+#include "game.h"
+#include "generator.h"
+#include "replay.h"
+#define GAME_OUT_BUF 65536
+
+char game_out_buf[GAME_OUT_BUF]; /*buffer of the standard output in the game*/
+
+
+/**
+ * parse_options - reads the command line options of the program:
+ * -t/--threads K - number of threads used for counting solutions (0 - all online cores, the default)
+ * --split-depth D - depth at which the solution count is split into subproblems for the threads
+ * --engine E - engine used to validate, hint and generate - gurobi (the default when built with Gurobi) or native
+ * --load-stats - print the size of every loaded board file and the throughput of parsing it
+ * --diff - after set, undo and redo print only the cells that changed, not the whole board (see print_changes)
+ * --batch OP - batch mode: solve, validate or count every board of the input instead of playing (see run_batch)
+ * --input F - file of the boards of batch mode, - for the standard input (the default)
+ * --count-cap K - in batch mode, stop counting the solutions of a board after K of them (0 - count all, the default)
+ * --workers K - number of threads that solve the boards in batch mode or generate the puzzles (0 - all online cores,
+ * the default)
+ * --seed S - seed of the puzzle generator, for the same puzzles on every run (the default is taken from the clock)
+ * --generate K - generate K puzzles with a unique solution and write them one per line, instead of playing
+ * --size MxN - block dimensions of the generated puzzles (3x3 - 9x9 puzzles, the default)
+ * --clues Y - stop removing the clues of a generated puzzle at Y (0 - remove all that can be removed, the default)
+ * --max-clues C - write only generated puzzles with at most C clues (0 - no limit, the default)
+ * --difficulty MIN[-MAX] - write only generated puzzles the native solver needs MIN to MAX search nodes for
+ * --output F - write the generated puzzles to F in the format of save, - for one per line to the standard output
+ * --replay F - run the commands of script F (- for the standard input) and report their latencies (see run_replay)
+ * --replay-echo - write the output of the replayed commands instead of discarding it
+ * @param
+ * argc - number of arguments
+ * argv - the arguments
+ * @return
+ * 1 - if all options are legal
+ * 0 - otherwise
+ */
+int parse_options(int argc, char** argv) {
+	int i; int val;
+	for (i = 1; i < argc; i++) {
+		if (!strcmp(argv[i],"--load-stats")) { /*an option without a value*/
+			set_load_stats(1);
+			continue;
+		}
+		if (!strcmp(argv[i],"--diff")) {
+			set_diff_boards(1);
+			continue;
+		}
+		if (!strcmp(argv[i],"--replay-echo")) {
+			set_replay_echo(1);
+			continue;
+		}
+		if (i+1 == argc)
+			return 0;
+		val = atoi(argv[i+1]);
+		if ((!strcmp(argv[i],"-t") || !strcmp(argv[i],"--threads")) && val >= 0)
+			set_count_threads(val);
+		else if (!strcmp(argv[i],"--split-depth") && val >= 1)
+			set_split_depth(val);
+		else if (!strcmp(argv[i],"--engine") && set_solver_engine(argv[i+1]))
+			;
+		else if (!strcmp(argv[i],"--batch") && set_batch_op(argv[i+1]))
+			;
+		else if (!strcmp(argv[i],"--input"))
+			set_batch_input(argv[i+1]);
+		else if (!strcmp(argv[i],"--count-cap") && val >= 0)
+			set_count_cap(val);
+		else if (!strcmp(argv[i],"--workers") && val >= 0) {
+			set_batch_workers(val);
+			set_gen_workers(val);
+		}
+		else if (!strcmp(argv[i],"--seed"))
+			set_gen_seed(strtoul(argv[i+1], NULL, 10));
+		else if (!strcmp(argv[i],"--generate") && val >= 1)
+			set_gen_count(val);
+		else if (!strcmp(argv[i],"--size") && set_gen_size(argv[i+1]))
+			;
+		else if (!strcmp(argv[i],"--clues") && val >= 0)
+			set_gen_clues(val);
+		else if (!strcmp(argv[i],"--max-clues") && val >= 0)
+			set_gen_max_clues(val);
+		else if (!strcmp(argv[i],"--difficulty") && set_gen_difficulty(argv[i+1]))
+			;
+		else if (!strcmp(argv[i],"--output"))
+			set_gen_output(argv[i+1]);
+		else if (!strcmp(argv[i],"--replay"))
+			set_replay_input(argv[i+1]);
+		else
+			return 0;
+		i++;
+	}
+	return 1;
+}
+
+int main (int argc, char** argv) {
 	int command_res = 1;
 	int count_hid;
 	int rows;
 	int cols;
 	MODE mode = INIT;
-	MoveList* curr_move = create_move_list (NULL,NULL);
+	MoveList* curr_move = create_move_list (NULL,0); /*the empty node, first node of the move pool*/
 	int mark_errors = 1;
-	Num*** board = NULL;
-	srand(time(NULL));
+	Board* board = NULL;
+	if (!parse_options(argc, argv)) {
+		print_usage(argv[0]);
+		return 1;
+	}
+	if (batch_mode()) { /*no game, the boards are read by run_batch*/
+		free_move_pool();
+		return run_batch();
+	}
+	if (gen_mode()) { /*no game, the puzzles are written by run_generator*/
+		free_move_pool();
+		return run_generator();
+	}
+	setvbuf(stdout, game_out_buf, _IOFBF, GAME_OUT_BUF); /*flushed once a command is done, also on a terminal*/
+	if (replay_mode()) /*the commands are read by run_replay*/
+		return run_replay(&board,&rows,&cols,&count_hid,&mode,&mark_errors,&curr_move);
 	
 	printf("Sudoku\n------\n");
 	command_res = get_command(&board,&rows,&cols, &count_hid, &mode, &mark_errors, &curr_move);
@@ -70,6 +70,17 @@ void print_hint(int dig) {
 	printf("Hint: set cell to %d\n", dig);
 }
 
+/*
+ * print_hint_cell - prints a hint with value dig for the cell on column x and row y.
+ * @param
+ * x - column
+ * y - row
+ * dig - the value of the cell in the solution
+ */
+void print_hint_cell(int x, int y, int dig) {
+	printf("Hint: set cell <%d,%d> to %d\n", x+1, y+1, dig);
+}
+
 void print_reset() {
 	printf("Board reset\n");
 }
@@ -92,8 +103,17 @@ void print_file_err_edit() {
  * @param
  * num - number of solutions
  */
-void print_num_sols(int num) {
-	printf("Number of solutions: %d\n", num);
+void print_num_sols(long num) {
+	printf("Number of solutions: %ld\n", num);
+}
+
+/*
+ * print_num_sols_cap - prints that counting stopped after num solutions.
+ * @param
+ * num - number of solutions found
+ */
+void print_num_sols_cap(long num) {
+	printf("Number of solutions: at least %ld (stopped counting)\n", num);
 }
 
 void print_good_board() {
@@ -107,3 +127,130 @@ void print_multi_sols() {
 void print_gen_failed() {
 	printf("Error: puzzle generator failed\n");
 }
+
+void print_autofill_failed() {
+	printf("Error: autofill failed\n");
+}
+
+/**
+ * print_autofill_stats - prints the number of cells autofill filled, and the number of rounds it took.
+ * @param
+ * cells - number of cells filled
+ * rounds - number of rounds that filled cells
+ */
+void print_autofill_stats(int cells, int rounds) {
+	printf("Autofill: %d cells filled in %d rounds\n", cells, rounds);
+}
+
+/*
+ * print_usage - prints the command line options of the program.
+ * @param
+ * prog - name of the program
+ */
+void print_usage(char* prog) {
+	printf("Usage: %s [-t|--threads K] [--split-depth D] [--engine gurobi|native] [--load-stats] [--diff] [--seed S]\n"
+			"       %s --batch solve|validate|count [--input FILE] [--count-cap K] [--workers K] [-t K]\n"
+			"       %*s [--engine gurobi|native]\n"
+			"       %s --generate K [--size MxN] [--clues Y] [--seed S] [--workers K] [--max-clues C]\n"
+			"       %*s [--difficulty MIN[-MAX]] [--output FILE]\n"
+			"       %s --replay FILE [--replay-echo] [--diff] [--engine gurobi|native]\n", prog, prog,
+			(int) strlen(prog), "", prog, (int) strlen(prog), "", prog);
+}
+
+/*
+ * print_load_stats - prints the size of a loaded file, the time it took to parse it and the throughput.
+ * @param
+ * bytes - size of the file
+ * secs - time it took to parse the file and build the board's index, in seconds
+ */
+void print_load_stats(long bytes, double secs) {
+	printf("Loaded %ld bytes in %.3f ms (%.1f MB/s)\n", bytes, 1000*secs, secs > 0 ? bytes/secs/1e6 : 0.0);
+}
+
+/*
+ * print_batch_stats - prints to the standard error the number of boards done in batch mode, and their rate.
+ * @param
+ * boards - number of boards
+ * secs - time it took to read, solve and write them, in seconds
+ */
+void print_batch_stats(long boards, double secs) {
+	fprintf(stderr, "Batch: %ld puzzles in %.3f s (%.1f puzzles/s)\n", boards, secs, secs > 0 ? boards/secs : 0.0);
+}
+
+/**
+ * print_stage_stats - prints to the standard error the time a stage of the batch pipeline was busy, and its throughput.
+ * @param
+ * stage - name of the stage
+ * threads - number of threads that run the stage
+ * boards - number of boards the stage handled
+ * secs - time the threads of the stage were busy, summed over the threads, in seconds
+ */
+void print_stage_stats(char* stage, int threads, long boards, double secs) {
+	fprintf(stderr, "  %-6s %2d thread(s), %.3f s busy (%.1f puzzles/s per thread)\n", stage, threads, secs,
+			secs > 0 ? boards/secs : 0.0);
+}
+
+/**
+ * print_queue_stats - prints to the standard error the depth of a queue of the batch pipeline.
+ * @param
+ * queue - name of the queue
+ * avg - average number of boards in the queue, sampled whenever a board was added or removed
+ * max - largest number of boards seen in the queue
+ */
+void print_queue_stats(char* queue, double avg, long max) {
+	fprintf(stderr, "  %-6s queue depth %.1f on average, %ld at most\n", queue, avg, max);
+}
+
+/**
+ * print_gen_stats - prints to the standard error the number of puzzles generated in bulk, their rate, and how many
+ * puzzles were made to get them when some were filtered out.
+ * @param
+ * puzzles - number of puzzles written
+ * tried - number of puzzles made, including the filtered out ones
+ * secs - time it took to generate and write them, in seconds
+ * avg_clues - average number of clues of a written puzzle
+ * avg_nodes - average difficulty of a written puzzle, in search nodes of the native solver
+ */
+void print_gen_stats(long puzzles, long tried, double secs, double avg_clues, double avg_nodes) {
+	fprintf(stderr, "Generated: %ld puzzles in %.3f s (%.1f puzzles/s), %.1f clues and %.1f search nodes on average\n",
+			puzzles, secs, secs > 0 ? puzzles/secs : 0.0, avg_clues, avg_nodes);
+	if (tried > puzzles)
+		fprintf(stderr, "  %ld puzzles made, %ld filtered out\n", tried, tried-puzzles);
+}
+
+/**
+ * print_replay_stats - prints to the standard error the number of commands replayed, and their throughput.
+ * @param
+ * commands - number of commands
+ * secs - time it took to read and run them, in seconds
+ */
+void print_replay_stats(long commands, double secs) {
+	fprintf(stderr, "Replay: %ld commands in %.3f s (%.1f commands/s)\n", commands, secs,
+			secs > 0 ? commands/secs : 0.0);
+	fprintf(stderr, "  %-14s %8s %7s %10s %10s %10s %10s %10s\n", "command", "count", "errors", "mean us", "p50 us",
+			"p90 us", "p99 us", "max us");
+}
+
+/**
+ * print_latency_row - prints to the standard error the latencies of one command of a replay.
+ * @param
+ * name - name of the command
+ * count - number of runs
+ * errors - number of runs that returned an error
+ * mean - mean latency, in seconds
+ * p50, p90, p99 - percentiles of the latency, in seconds
+ * max - largest latency, in seconds
+ */
+void print_latency_row(char* name, long count, long errors, double mean, double p50, double p90, double p99,
+		double max) {
+	fprintf(stderr, "  %-14s %8ld %7ld %10.1f %10.1f %10.1f %10.1f %10.1f\n", name, count, errors, 1e6*mean, 1e6*p50,
+			1e6*p90, 1e6*p99, 1e6*max);
+}
+
+/**
+ * print_not_unique - prints that the generated puzzle has more than one solution - the requested number of cells is
+ * smaller than the number of clues a unique solution needs.
+ */
+void print_not_unique() {
+	printf("Note: the puzzle has more than one solution, it can't be made unique with so few cells\n");
+}
@@ -14,15 +14,28 @@
  * print_fixed - prints an error that requested cell is fixed
  * print_contains_val - prints an error that requested cell already contains a value
  * print_hint - prints a hint with value dig.
+ * print_hint_cell - prints a hint with value dig for the cell on column x and row y.
  * print_reset - prints that board was reset.
  * print_err_validation - prints an error that validation failed
  * print_file_err_save - prints that file could not be created or modified
  * print_file_err_solve - prints that file doesnt exist or cannot be opened
  * print_file_err_edit - prints that file cannot be opened
  * print_num_sols - prints number of solutions of the board.
+ * print_num_sols_cap - prints that counting solutions stopped after the given number of solutions.
  * print_good_board - prints that the board is good.
  * print_multi_sols - prints that the user should try to edit the board further.
  * print_gen_failed - prints that puzzle generator failed.
+ * print_usage - prints the command line options of the program.
+ * print_load_stats - prints the size of a loaded file and the throughput of parsing it.
+ * print_batch_stats - prints the number of boards done in batch mode, and their rate.
+ * print_stage_stats - prints the busy time and the throughput of a stage of the batch pipeline.
+ * print_queue_stats - prints the average and the largest depth of a queue of the batch pipeline.
+ * print_autofill_failed - prints that autofill failed.
+ * print_autofill_stats - prints the number of cells autofill filled and the number of rounds it took.
+ * print_gen_stats - prints the number of puzzles generated in bulk, their rate, average clues and difficulty.
+ * print_replay_stats - prints the number of commands replayed and their throughput.
+ * print_latency_row - prints the count, errors, mean and percentiles of the latency of one replayed command.
+ * print_not_unique - prints that the generated puzzle has more than one solution.
  */
  
 extern void print_invalid();
@@ -47,6 +60,8 @@ extern void print_contains_val();
 
 extern void print_hint(int dig);
 
+extern void print_hint_cell(int x, int y, int dig);
+
 extern void print_reset();
 
 extern void print_err_validation();
@@ -57,10 +72,35 @@ void print_file_err_solve();
 
 void print_file_err_edit();
 
-void print_num_sols(int num);
+void print_num_sols(long num);
+
+void print_num_sols_cap(long num);
 
 void print_good_board();
 
 void print_multi_sols();
 
 void print_gen_failed();
+
+void print_usage(char* prog);
+
+void print_load_stats(long bytes, double secs);
+
+void print_batch_stats(long boards, double secs);
+
+void print_stage_stats(char* stage, int threads, long boards, double secs);
+
+void print_queue_stats(char* queue, double avg, long max);
+
+void print_autofill_failed();
+
+void print_autofill_stats(int cells, int rounds);
+
+void print_gen_stats(long puzzles, long tried, double secs, double avg_clues, double avg_nodes);
+
+void print_replay_stats(long commands, double secs);
+
+void print_latency_row(char* name, long count, long errors, double mean, double p50, double p90, double p99,
+		double max);
+
+void print_not_unique();
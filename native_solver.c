@@ -0,0 +1,391 @@
+#include <stdlib.h>
+#include <string.h>
+#include "structs.h"
+#include "struct_functions.h"
+#include "native_solver.h"
+
+
+/**
+ * Type represents the state of the search at one level - the values of all cells and the digits used in every unit.
+ * units are numbered as in the board's constraint index - rows, then columns, then blocks.
+ */
+typedef struct search_level {
+	int* grid; /*value of each cell, 0 if empty*/
+	unsigned long* used; /*used[unit*words+w] - bitset of digits used in unit*/
+	int empty; /*number of empty cells*/
+	unsigned long* branch; /*candidates of the cell branched on at this level*/
+	int* order; /*the digits of branch, in the order they are tried*/
+} SearchLevel;
+
+/**
+ * Type represents a running search.
+ */
+typedef struct search {
+	Board* board; /*the solved board, for its dimensions*/
+	int N; int words;
+	int* cell_units; /*cell_units[cell*3+k] - the row, column and block of each cell*/
+	int* unit_cells; /*unit_cells[unit*N+k] - the cells of each unit*/
+	unsigned long* full; /*bitset of all digits 1..N*/
+	unsigned long* cand; /*scratch bitsets*/
+	unsigned long* once;
+	unsigned long* twice;
+	SearchLevel** levels; /*levels[k] - state at depth k, allocated on first use*/
+	int max_levels;
+	int* solution;
+	long nodes; /*number of search nodes visited*/
+	int failed; /*set if memory allocation failed*/
+	unsigned long* rng; /*state of the random generator the candidates are shuffled with, NULL to try them in order*/
+} Search;
+
+
+/**
+ * place - puts dig in a cell of a search level.
+ * @param
+ * srch - the search
+ * lvl - the level
+ * cell - index of the cell
+ * dig - the digit
+ * @return
+ * 1 - if dig was placed
+ * 0 - if dig is already used in one of the cell's units
+ */
+int place(Search* srch, SearchLevel* lvl, int cell, int dig) {
+	int k; int w = DIG_WORD(dig); unsigned long mask = DIG_MASK(dig); int unit;
+	for (k = 0; k < 3; k++) {
+		if (lvl->used[srch->cell_units[cell*3+k]*srch->words+w] & mask)
+			return 0;
+	}
+	for (k = 0; k < 3; k++) {
+		unit = srch->cell_units[cell*3+k];
+		lvl->used[unit*srch->words+w] |= mask;
+	}
+	lvl->grid[cell] = dig;
+	lvl->empty--;
+	return 1;
+}
+
+/**
+ * candidates - computes the candidates of an empty cell of a search level into srch->cand.
+ * @param
+ * srch - the search
+ * lvl - the level
+ * cell - index of the cell
+ * @return
+ * number of candidates
+ */
+int candidates(Search* srch, SearchLevel* lvl, int cell) {
+	int w; int words = srch->words;
+	unsigned long* r = lvl->used + srch->cell_units[cell*3]*words;
+	unsigned long* c = lvl->used + srch->cell_units[cell*3+1]*words;
+	unsigned long* b = lvl->used + srch->cell_units[cell*3+2]*words;
+	for (w = 0; w < words; w++)
+		srch->cand[w] = srch->full[w] & ~(r[w] | c[w] | b[w]);
+	return count_digs(srch->cand, words);
+}
+
+/**
+ * hidden_singles - places every digit which has a single possible cell in some unit.
+ * @param
+ * srch - the search
+ * lvl - the level
+ * @return
+ * number of cells filled, -1 if some unit has a missing digit with no possible cell (a contradiction)
+ */
+int hidden_singles(Search* srch, SearchLevel* lvl) {
+	int unit; int k; int w; int cell; int dig; int filled = 0; int words = srch->words; int N = srch->N;
+	unsigned long* used;
+	for (unit = 0; unit < 3*N; unit++) {
+		used = lvl->used + unit*words;
+		memset(srch->once, 0, words*sizeof(unsigned long));
+		memset(srch->twice, 0, words*sizeof(unsigned long));
+		for (k = 0; k < N; k++) { /*find the digits that may go in one cell of the unit, or in more*/
+			cell = srch->unit_cells[unit*N+k];
+			if (lvl->grid[cell] != 0)
+				continue;
+			candidates(srch, lvl, cell);
+			for (w = 0; w < words; w++) {
+				srch->twice[w] |= srch->once[w] & srch->cand[w];
+				srch->once[w] |= srch->cand[w];
+			}
+		}
+		for (w = 0; w < words; w++) {
+			if (srch->full[w] & ~used[w] & ~srch->once[w]) /*a missing digit can't go anywhere*/
+				return -1;
+			srch->once[w] &= ~srch->twice[w];
+		}
+		for (dig = next_dig(srch->once, words, 1); dig != 0; dig = next_dig(srch->once, words, dig+1)) {
+			/*a cell filled by an earlier single of this unit is skipped. if it was the digit's only place, the digit is
+			left unplaced, and the next pass of propagate finds that it can't go anywhere*/
+			for (k = 0; k < N; k++) {
+				cell = srch->unit_cells[unit*N+k];
+				if (lvl->grid[cell] == 0 && candidates(srch, lvl, cell) > 0
+						&& (srch->cand[DIG_WORD(dig)] & DIG_MASK(dig))) {
+					if (!place(srch, lvl, cell, dig))
+						return -1;
+					filled++;
+					break;
+				}
+			}
+		}
+	}
+	return filled;
+}
+
+/**
+ * propagate - fills naked singles and hidden singles until nothing changes, and finds the empty cell with the fewest
+ * candidates.
+ * @param
+ * srch - the search
+ * lvl - the level
+ * best - pointer to variable to hold the index of the empty cell with the fewest candidates
+ * @return
+ * 1 - if the level is consistent
+ * 0 - if a contradiction was found
+ */
+int propagate(Search* srch, SearchLevel* lvl, int* best) {
+	int cell; int count; int best_count; int changed = 1; int res; int NN = srch->N*srch->N;
+	while (changed && lvl->empty > 0) {
+		changed = 0;
+		best_count = srch->N+1;
+		*best = -1;
+		for (cell = 0; cell < NN; cell++) { /*naked singles*/
+			if (lvl->grid[cell] != 0)
+				continue;
+			count = candidates(srch, lvl, cell);
+			if (count == 0)
+				return 0;
+			if (count == 1) {
+				place(srch, lvl, cell, next_dig(srch->cand, srch->words, 1));
+				changed = 1;
+			}
+			else if (count < best_count) {
+				best_count = count;
+				*best = cell;
+			}
+		}
+		if (!changed) { /*hidden singles*/
+			res = hidden_singles(srch, lvl);
+			if (res < 0)
+				return 0;
+			changed = res > 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * get_level - returns the state of depth k, allocating it on first use.
+ * @param
+ * srch - the search
+ * k - the depth
+ * @return
+ * pointer to the level, NULL if memory allocation failed
+ */
+SearchLevel* get_level(Search* srch, int k) {
+	SearchLevel* lvl = srch->levels[k];
+	if (lvl == NULL) {
+		lvl = malloc(sizeof(SearchLevel));
+		if (!lvl)
+			return NULL;
+		lvl->grid = malloc(srch->N*srch->N*sizeof(int));
+		lvl->used = malloc(3*srch->N*srch->words*sizeof(unsigned long));
+		lvl->branch = malloc(srch->words*sizeof(unsigned long));
+		lvl->order = malloc(srch->N*sizeof(int));
+		if (!lvl->grid || !lvl->used || !lvl->branch || !lvl->order) {
+			free(lvl->grid);
+			free(lvl->used);
+			free(lvl->branch);
+			free(lvl->order);
+			free(lvl);
+			return NULL;
+		}
+		srch->levels[k] = lvl;
+	}
+	return lvl;
+}
+
+/**
+ * copy_level - copies the state of one level to another.
+ * @param
+ * srch - the search
+ * dst - the level to copy to
+ * src - the level to copy from
+ */
+void copy_level(Search* srch, SearchLevel* dst, SearchLevel* src) {
+	memcpy(dst->grid, src->grid, srch->N*srch->N*sizeof(int));
+	memcpy(dst->used, src->used, 3*srch->N*srch->words*sizeof(unsigned long));
+	dst->empty = src->empty;
+}
+
+/**
+ * search_level - propagates the state at depth k, and if the board isn't solved yet, tries every candidate of the
+ * empty cell with the fewest candidates, each on a copy of the state at depth k+1. the candidates are tried in
+ * increasing order, or in a random order when the search has a random generator (see random_solve).
+ * @param
+ * srch - the search
+ * k - the depth
+ * @return
+ * 1 - if a solution was found (it is copied to srch->solution)
+ * 0 - otherwise
+ */
+int search_level(Search* srch, int k) {
+	SearchLevel* lvl = srch->levels[k]; SearchLevel* next; int best; int dig; int count = 0; int i; int j;
+	srch->nodes++;
+	if (!propagate(srch, lvl, &best))
+		return 0;
+	if (lvl->empty == 0) {
+		memcpy(srch->solution, lvl->grid, srch->N*srch->N*sizeof(int));
+		return 1;
+	}
+	next = get_level(srch, k+1);
+	if (!next) {
+		srch->failed = 1;
+		return 0;
+	}
+	candidates(srch, lvl, best);
+	memcpy(lvl->branch, srch->cand, srch->words*sizeof(unsigned long));
+	for (dig = next_dig(lvl->branch, srch->words, 1); dig != 0; dig = next_dig(lvl->branch, srch->words, dig+1))
+		lvl->order[count++] = dig;
+	for (i = count-1; i > 0 && srch->rng != NULL; i--) { /*Fisher-Yates shuffle*/
+		j = (int) (next_rand(srch->rng) % (i+1));
+		dig = lvl->order[i];
+		lvl->order[i] = lvl->order[j];
+		lvl->order[j] = dig;
+	}
+	for (i = 0; i < count && !srch->failed; i++) {
+		copy_level(srch, next, lvl);
+		place(srch, next, best, lvl->order[i]);
+		if (search_level(srch, k+1))
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * init_search - allocates a search over a board and fills its first level with the board's filled cells.
+ * @param
+ * srch - the search
+ * board - the board
+ * solution - array of N*N to hold the solution
+ * @return
+ * 1 - on success
+ * 0 - if two filled cells of the board conflict (the board is unsolvable)
+ * -1 - if memory allocation failed
+ */
+int init_search(Search* srch, Board* board, int* solution) {
+	int N = board->N; int words = board->words; int row; int col; int cell; int unit; int w; int k;
+	int* fill; SearchLevel* first;
+	memset(srch, 0, sizeof(Search));
+	srch->board = board;
+	srch->N = N;
+	srch->words = words;
+	srch->solution = solution;
+	srch->max_levels = N*N+1;
+	srch->cell_units = malloc(3*N*N*sizeof(int));
+	srch->unit_cells = malloc(3*N*N*sizeof(int));
+	srch->full = calloc(words,sizeof(unsigned long));
+	srch->cand = malloc(words*sizeof(unsigned long));
+	srch->once = malloc(words*sizeof(unsigned long));
+	srch->twice = malloc(words*sizeof(unsigned long));
+	srch->levels = calloc(srch->max_levels,sizeof(SearchLevel*));
+	fill = calloc(3*N,sizeof(int));
+	if (!srch->cell_units || !srch->unit_cells || !srch->full || !srch->cand || !srch->once || !srch->twice
+			|| !srch->levels || !fill || !(first = get_level(srch, 0))) {
+		free(fill);
+		return -1;
+	}
+	for (k = 1; k <= N; k++)
+		srch->full[DIG_WORD(k)] |= DIG_MASK(k);
+	for (row = 0; row < N; row++) { /*cell <-> unit tables*/
+		for (col = 0; col < N; col++) {
+			cell = CELL_IDX(board,row,col);
+			srch->cell_units[cell*3] = ROW_UNIT(board,row);
+			srch->cell_units[cell*3+1] = COL_UNIT(board,col);
+			srch->cell_units[cell*3+2] = BLOCK_UNIT(board,row,col);
+			for (k = 0; k < 3; k++) {
+				unit = srch->cell_units[cell*3+k];
+				srch->unit_cells[unit*N+fill[unit]++] = cell;
+			}
+		}
+	}
+	free(fill);
+	for (w = 0; w < 3*N*words; w++)
+		first->used[w] = 0;
+	memset(first->grid, 0, N*N*sizeof(int));
+	first->empty = N*N;
+	for (cell = 0; cell < N*N; cell++) {
+		if (NUM_AT(board,cell) != 0 && !place(srch, first, cell, NUM_AT(board,cell)))
+			return 0;
+	}
+	return 1;
+}
+
+/**
+ * free_search - frees the memory of a search.
+ * @param
+ * srch - the search
+ */
+void free_search(Search* srch) {
+	int k;
+	if (srch->levels) {
+		for (k = 0; k < srch->max_levels; k++) {
+			if (srch->levels[k]) {
+				free(srch->levels[k]->grid);
+				free(srch->levels[k]->used);
+				free(srch->levels[k]->branch);
+				free(srch->levels[k]->order);
+				free(srch->levels[k]);
+			}
+		}
+	}
+	free(srch->levels);
+	free(srch->cell_units);
+	free(srch->unit_cells);
+	free(srch->full);
+	free(srch->cand);
+	free(srch->once);
+	free(srch->twice);
+}
+
+/**
+ * native_solve - solves a board according to its cells' num values, without changing it.
+ * @param
+ * board - the board
+ * solution - array of N*N to hold the solution, in the board's row-major cell order
+ * nodes - pointer to variable to hold the number of search nodes visited, may be NULL
+ * @return
+ * 1 - if the board is solvable (solution holds a solution)
+ * 0 - if the board is unsolvable
+ * -1 - if memory allocation failed
+ */
+int native_solve(Board* board, int* solution, long* nodes) {
+	return random_solve(board, solution, NULL, nodes);
+}
+
+/**
+ * random_solve - solves a board as native_solve does, trying the candidates of every cell branched on in a random
+ * order. on a board with few filled cells this gives a random solution - on an empty board, a random full grid.
+ * @param
+ * board - the board
+ * solution - array of N*N to hold the solution, in the board's row-major cell order
+ * rng - state of the random generator (see next_rand), NULL to try the candidates in order, as native_solve does
+ * nodes - pointer to variable to hold the number of search nodes visited, may be NULL
+ * @return
+ * 1 - if the board is solvable (solution holds a solution)
+ * 0 - if the board is unsolvable
+ * -1 - if memory allocation failed
+ */
+int random_solve(Board* board, int* solution, unsigned long* rng, long* nodes) {
+	Search srch; int res;
+	res = init_search(&srch, board, solution);
+	srch.rng = rng;
+	if (res == 1) {
+		res = search_level(&srch, 0);
+		if (srch.failed)
+			res = -1;
+	}
+	if (nodes)
+		*nodes = srch.nodes;
+	free_search(&srch);
+	return res;
+}
@@ -0,0 +1,16 @@
+/**
+* native_solver Summary:
+* A built-in Sudoku solver, which doesn't need Gurobi. Keeps the digits used in every row, column and block as bitsets,
+* propagates naked singles (cells with a single candidate) and hidden singles (digits with a single place in a unit)
+* until nothing changes, and then backtracks on the empty cell with the fewest candidates (MRV).
+*
+* supports the following functions:
+*
+* native_solve - solves a board, according to its cells' num values.
+* random_solve - solves a board trying the candidates in a random order, which gives a random full grid.
+*
+*/
+
+extern int native_solve(Board* board, int* solution, long* nodes);
+
+extern int random_solve(Board* board, int* solution, unsigned long* rng, long* nodes);
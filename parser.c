@@ -1,92 +1,437 @@
+#define _POSIX_C_SOURCE 200112L
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include "main_aux.h"
 #include "structs.h"
+#include "struct_functions.h"
 #include "game.h"
 #include "solver.h"
-#include "time.h"
 #define DELIMITERS " \n\t\v\f\r"
-#define COMMAND_LEN 256
+#define IS_DELIM(c) ((c) == ' ' || (c) == '\n' || (c) == '\t' || (c) == '\v' || (c) == '\f' || (c) == '\r')
+#define LINE_START 256 /*first size of the buffer of a command line*/
+#define CMD_SLOTS 64 /*size of the hash table of the commands, a power of 2*/
+#define READ_CHUNK 65536
 
+int load_stats = 0; /*whether to print the size and the speed of loading a board*/
 
 /**
-* using the function strtok, the function checks if the next token in command is legal.
-* if token isn't legal, function prints an error message. if token is legal, function returns it. (a pointer to the first character of token)
-*
-* @param parsed_command - the current token.
-* @return
-* 0 - if next token got from strtok == NULL
-* parsed_command (the next token) - otherwise
-*/
-char* check_next_tok(char* parsed_command) { 
-	parsed_command = strtok(NULL,DELIMITERS);
-	if (parsed_command == NULL) {
-		print_invalid();
-	}
-	return parsed_command;
+ * set_load_stats - sets whether loading a board prints the file's size and the parse throughput.
+ * @param
+ * on - 1 to print them, 0 not to
+ */
+void set_load_stats(int on) {
+	load_stats = on;
 }
 
+
 /**
- * check_integer:
+ * seconds_since - measures the time that passed since a given time, and advances it to the current time.
  * @param
- * num - a double
+ * since - the time to measure from, set to the current time
  * @return
- * 1 if num is integer (its fraction is 0)
- * 0 otherwise
+ * number of seconds passed
  */
-int check_integer(double num) {
-	if (num - (int) num == 0)
-		return 1;
-	return 0;
+double seconds_since(struct timespec* since) {
+	struct timespec now; double secs;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	secs = (now.tv_sec - since->tv_sec) + (now.tv_nsec - since->tv_nsec)/1e9;
+	*since = now;
+	return secs;
+}
+
+/**
+ * map_file - gives the content of a file in memory. a regular file is mapped with mmap, so it is read without being
+ * copied; other files (such as pipes) are read whole into an allocated buffer.
+ * @param
+ * fp - the file
+ * len - pointer to the length of the content, set by the function
+ * mapped - pointer to a flag set by the function - 1 if the content is mapped, 0 if it was allocated
+ * @return
+ * pointer to the content, NULL if the file is empty or could not be read
+ */
+char* map_file(FILE* fp, size_t* len, int* mapped) {
+	struct stat st; char* data; char* more; size_t cap = READ_CHUNK; size_t got;
+	*len = 0;
+	*mapped = 0;
+	if (fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode)) {
+		if (st.st_size == 0)
+			return NULL;
+		data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+		if (data != MAP_FAILED) {
+			*len = st.st_size;
+			*mapped = 1;
+			return data;
+		}
+	}
+	data = malloc(cap); /*not a regular file, or mmap failed*/
+	while (data != NULL && (got = fread(data + *len, 1, cap - *len, fp)) > 0) {
+		*len += got;
+		if (*len == cap) {
+			cap *= 2;
+			if (!(more = realloc(data, cap)))
+				free(data);
+			data = more;
+		}
+	}
+	if (data == NULL || ferror(fp) || *len == 0) {
+		free(data);
+		return NULL;
+	}
+	return data;
 }
 
 /**
- * read_args - reads the specified number of arguments from the given command and checks if they are legal.
- * function only checks proper number of arguments and integer value of them when needed.
- * if number is not integer, function changes it to -1.
- * function updates the values of parameters. prints error messages if values aren't legal.
+ * refill_reader - reads more of the stream of a token reader into its buffer. the bytes before the current position
+ * are dropped, and the buffer grows when the bytes after it fill it.
  * @param
- * parsed_command - the given command
- * args_num - number of arguments of the proper command
- * x - pointer to variable x
- * y - pointer to variable y
- * z - pointer to variable z
- * func - name of calling function
+ * rd - the token reader
  * @return
- * 1 - if command is legal or number is not integer
- * 0 - otherwise (illegal command)
+ * 1 - if bytes were read
+ * 0 - if the reader has no stream, or it ended (or failed)
  */
-int read_args(char** parsed_command, int args_num, double* x, double* y, double* z, char* func) {
-	*parsed_command = check_next_tok(*parsed_command);
-	if (*parsed_command == NULL)
+int refill_reader(TokenReader* rd) {
+	char* more; size_t got;
+	if (rd->fp == NULL || rd->eof)
 		return 0;
-	*x = atof(*parsed_command);
-	if (args_num > 1) {
-		*parsed_command = check_next_tok(*parsed_command);
-		if (*parsed_command == NULL)
+	if (rd->pos > 0) { /*the buffer is NULL before the first read*/
+		memmove(rd->buf, rd->buf + rd->pos, rd->len - rd->pos);
+		rd->len -= rd->pos;
+		rd->pos = 0;
+	}
+	if (rd->len == rd->cap) {
+		more = realloc(rd->buf, rd->cap == 0 ? READ_CHUNK : 2*rd->cap);
+		if (!more) {
+			rd->eof = 1;
 			return 0;
-		*y = atof(*parsed_command);
+		}
+		rd->cap = rd->cap == 0 ? READ_CHUNK : 2*rd->cap;
+		rd->buf = more;
 	}
-	if (args_num > 2) {
-		*parsed_command = check_next_tok(*parsed_command);
-		if (*parsed_command == NULL)
+	got = fread(rd->buf + rd->len, 1, rd->cap - rd->len, rd->fp);
+	rd->len += got;
+	if (got == 0)
+		rd->eof = 1;
+	return got > 0;
+}
+
+/**
+ * next_token - finds the next token (a sequence of characters between delimiters) of a token reader.
+ * @param
+ * rd - the token reader
+ * tok_len - pointer to the length of the token, set by the function
+ * @return
+ * pointer to the token in the reader's buffer, valid until the next call. NULL if there are no more tokens.
+ */
+char* next_token(TokenReader* rd, size_t* tok_len) {
+	size_t end; char* tok;
+	for (;;) {
+		while (rd->pos < rd->len && IS_DELIM(rd->buf[rd->pos]))
+			rd->pos++;
+		for (end = rd->pos; end < rd->len && !IS_DELIM(rd->buf[end]); end++)
+			;
+		if (end == rd->len && refill_reader(rd)) /*the token may go on in the stream*/
+			continue;
+		if (rd->pos == rd->len)
+			return NULL;
+		tok = rd->buf + rd->pos;
+		*tok_len = end - rd->pos;
+		rd->pos = end;
+		return tok;
+	}
+}
+
+/**
+ * token_value - reads the number at the start of a token, as atoi would.
+ * @param
+ * tok - the token
+ * len - length of the token
+ * @return
+ * the number, 0 if the token doesn't start with one
+ */
+int token_value(char* tok, size_t len) {
+	size_t i = 0; int val = 0; int neg = (len > 0 && tok[0] == '-');
+	if (len > 0 && (tok[0] == '-' || tok[0] == '+'))
+		i++;
+	for (; i < len && tok[i] >= '0' && tok[i] <= '9'; i++)
+		val = 10*val + (tok[i] - '0');
+	return neg ? -val : val;
+}
+
+/**
+ * line_digit - reads a cell of a board written in one line: '0' or '.' for an empty cell, '1'-'9' for 1-9 and
+ * 'A'-'Z' (or 'a'-'z') for 10-35.
+ * @param
+ * ch - the character
+ * @return
+ * the value of the cell, -1 if ch is not a cell
+ */
+int line_digit(char ch) {
+	if (ch == '.')
+		return 0;
+	if (ch >= '0' && ch <= '9')
+		return ch - '0';
+	if (ch >= 'A' && ch <= 'Z')
+		return ch - 'A' + 10;
+	if (ch >= 'a' && ch <= 'z')
+		return ch - 'a' + 10;
+	return -1;
+}
+
+/**
+ * line_token - finds the next token of a token reader if it is on the current line (see next_token).
+ * @param
+ * rd - the token reader
+ * tok_len - pointer to the length of the token, set by the function
+ * @return
+ * pointer to the token in the reader's buffer, valid until the next call. NULL if the line or the input ended first.
+ */
+char* line_token(TokenReader* rd, size_t* tok_len) {
+	for (;;) {
+		while (rd->pos < rd->len && rd->buf[rd->pos] != '\n' && IS_DELIM(rd->buf[rd->pos]))
+			rd->pos++;
+		if (rd->pos < rd->len || !refill_reader(rd))
+			break;
+	}
+	if (rd->pos == rd->len || rd->buf[rd->pos] == '\n')
+		return NULL;
+	return next_token(rd, tok_len);
+}
+
+/**
+ * skip_line - skips the rest of the current line of a token reader, including its end of line.
+ * @param
+ * rd - the token reader
+ */
+void skip_line(TokenReader* rd) {
+	for (;;) {
+		while (rd->pos < rd->len && rd->buf[rd->pos] != '\n')
+			rd->pos++;
+		if (rd->pos < rd->len) {
+			rd->pos++;
+			return;
+		}
+		if (!refill_reader(rd))
+			return;
+	}
+}
+
+/**
+ * prepare_board - gives an empty board of the given size. the given board is emptied and reused if it is of this
+ * size, otherwise it is freed and a new one is created.
+ * @param
+ * board - pointer to the board, may point to NULL
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * alloc_secs - pointer to a time in seconds to add the time of creating a board to, may be NULL
+ * @return
+ * 1 - on success
+ * 0 - if the board could not be created
+ */
+int prepare_board(Board** board, int m, int n, double* alloc_secs) {
+	int idx; struct timespec since;
+	if (*board != NULL && (*board)->m == m && (*board)->n == n) {
+		for (idx = 0; idx < m*n*m*n; idx++) {
+			NUM_AT((*board),idx) = 0;
+			ALT_AT((*board),idx) = 0;
+			STAT_AT((*board),idx) = HIDDEN;
+		}
+		(*board)->sol_state = 0;
+		return 1;
+	}
+	if (*board != NULL)
+		free_board(board);
+	clock_gettime(CLOCK_MONOTONIC, &since);
+	*board = create_empty_board(m, n);
+	if (alloc_secs != NULL)
+		*alloc_secs += seconds_since(&since);
+	return *board != NULL;
+}
+
+/**
+ * buffer_bytes - makes the next bytes of a token reader available in its buffer, reading more of its stream if needed.
+ * @param
+ * rd - the token reader
+ * count - number of bytes needed from the current position
+ * @return
+ * 1 - if the buffer holds count bytes from the current position
+ * 0 - if the input ended before them
+ */
+int buffer_bytes(TokenReader* rd, size_t count) {
+	while (rd->len - rd->pos < count) {
+		if (!refill_reader(rd))
 			return 0;
-		*z = atof(*parsed_command);
 	}
-	if ((!check_integer(*x) || (*x == 0.0 && **parsed_command != '0')) && strcmp(func,"solve") != 0 && strcmp(func,"save") != 0)
-		*x = -1;
-	if (args_num > 1 && (!check_integer(*y) || (*y == 0.0 && **parsed_command != '0')))
-		*y = -1;
-	if (args_num > 2 && (!check_integer(*z) || (*z == 0.0 && **parsed_command != '0')))
-		*z = -1;
 	return 1;
 }
 
+/**
+ * read_bin_board - reads a board in the binary board format (see BIN_MAGIC in structs.h) which starts at the current
+ * position of a token reader. the values are unpacked straight into the board, and the constraint index, the cells'
+ * statuses and the hash are built once at the end, as in read_board.
+ * @param
+ * rd - the token reader, at the magic of the board
+ * board - pointer to the board, reused if it has the read dimensions (see prepare_board)
+ * m - pointer to the number of rows in one block, set by the function
+ * n - pointer to the number of columns in one block, set by the function
+ * count_hid - pointer to the number of hidden cells, set by the function
+ * fixed - 1 to mark the cells of the bitmap of fixed cells as fixed
+ * alloc_secs - pointer to a time in seconds to add the time of creating a board to, may be NULL
+ * @return
+ * 1 - if a board was read
+ * -1 - if the board is not valid. a board of another version, or one cut short, ends the input - its length is unknown
+ */
+int read_bin_board(TokenReader* rd, Board** board, int* m, int* n, int* count_hid, int fixed, double* alloc_secs) {
+	unsigned char* in; unsigned char* fixed_map; size_t need; int N; int bits; int idx; int dig; int flags;
+	int valid = 1; unsigned long acc = 0; int acc_bits = 0;
+	if (!buffer_bytes(rd, BIN_HEADER)) {
+		rd->pos = rd->len;
+		return -1;
+	}
+	in = (unsigned char*) rd->buf + rd->pos;
+	flags = in[5];
+	*m = in[6] | (in[7] << 8);
+	*n = in[8] | (in[9] << 8);
+	if (in[4] != BIN_VERSION || *m < 1 || *n < 1 || (long) *m * *n > MAX_N) {
+		rd->pos = rd->len;
+		rd->eof = 1;
+		return -1;
+	}
+	N = *m**n;
+	bits = cell_bits(N);
+	need = BIN_HEADER + BIN_BYTES((size_t) N*N*bits) + ((flags & BIN_FIXED) ? BIN_BYTES((size_t) N*N) : 0);
+	if (!buffer_bytes(rd, need)) {
+		rd->pos = rd->len;
+		return -1;
+	}
+	in = (unsigned char*) rd->buf + rd->pos; /*the buffer may have moved*/
+	rd->pos += need;
+	if (!prepare_board(board, *m, *n, alloc_secs))
+		return -1;
+	fixed_map = in + BIN_HEADER + BIN_BYTES((size_t) N*N*bits);
+	fixed = fixed && (flags & BIN_FIXED);
+	in += BIN_HEADER;
+	*count_hid = N*N;
+	for (idx = 0; idx < N*N; idx++) {
+		for (; acc_bits < bits; acc_bits += 8)
+			acc |= (unsigned long) *in++ << acc_bits;
+		dig = (int) (acc & ((1UL << bits) - 1));
+		acc >>= bits;
+		acc_bits -= bits;
+		if (dig > N)
+			valid = 0;
+		else if (dig != 0) {
+			*count_hid -= 1;
+			NUM_AT((*board),idx) = dig;
+			if (fixed && ((fixed_map[idx >> 3] >> (idx & 7)) & 1))
+				STAT_AT((*board),idx) = FIXED;
+		}
+	}
+	build_board_index(*board); /*marks the cells ERRONEOUS, SHOWN or HIDDEN*/
+	return valid ? 1 : -1;
+}
+
+/**
+ * read_board - reads the next board of a token reader, in one of three formats:
+ *   1. the format save writes - the block's dimensions m and n, followed by the N*N cells' values in row-major
+ *      order, 0 for an empty cell. a value which ends with '.' is a fixed cell.
+ *   2. one line of N*N characters without spaces (see line_digit), such as the 81 characters of a 9x9 puzzle.
+ *      the dimensions of the block are the divisors of N closest to its square root, m <= n.
+ *   3. the binary format save_bin writes, told by its magic (see read_bin_board).
+ * the values are written to the board directly, and the constraint index, the cells' statuses and the hash are
+ * built once at the end. missing values at the end of the input are left empty.
+ * when the first line isn't the start of a board - a header without two positive numbers (or too large), or a one-line
+ * board of the wrong length or with a wrong character - the rest of the line is skipped, so a bad line is read as one
+ * invalid board. a board in the save format takes the N*N values after its header wherever they are, so a truncated
+ * board takes the values of the boards after it.
+ * @param
+ * rd - the token reader
+ * board - pointer to the board, reused if it has the read dimensions (see prepare_board)
+ * m - pointer to the number of rows in one block, set by the function
+ * n - pointer to the number of columns in one block, set by the function
+ * count_hid - pointer to the number of hidden cells, set by the function
+ * fixed - 1 to mark the given cells of a board in one line, and the values ending with '.', as fixed
+ * alloc_secs - pointer to a time in seconds to add the time of creating a board to, may be NULL
+ * @return
+ * 1 - if a board was read
+ * 0 - if there are no more boards
+ * -1 - if the board is not valid (it is consumed, so the next board can be read)
+ */
+int read_board(TokenReader* rd, Board** board, int* m, int* n, int* count_hid, int fixed, double* alloc_secs) {
+	char* tok; size_t len; int N; int dig; int idx; int valid = 1;
+	if ((tok = next_token(rd, &len)) == NULL)
+		return 0;
+	if (len >= 4 && !memcmp(tok, BIN_MAGIC, 4)) {
+		rd->pos = tok - rd->buf; /*the binary board starts at the token*/
+		return read_bin_board(rd, board, m, n, count_hid, fixed, alloc_secs);
+	}
+	if (len >= 4) { /*a board in one line*/
+		for (N = 2; N*N < (int) len; N++)
+			;
+		for (*m = 1; (*m+1)*(*m+1) <= N; (*m)++)
+			;
+		while (N % *m != 0)
+			(*m)--;
+		*n = N / *m;
+		if (N*N != (int) len || N > 35) {
+			skip_line(rd);
+			return -1;
+		}
+		if (!prepare_board(board, *m, *n, alloc_secs))
+			return -1;
+		*count_hid = N*N;
+		for (idx = 0; idx < N*N; idx++) {
+			dig = line_digit(tok[idx]);
+			if (dig < 0 || dig > N)
+				valid = 0;
+			else if (dig != 0) {
+				*count_hid -= 1;
+				NUM_AT((*board),idx) = dig;
+				if (fixed)
+					STAT_AT((*board),idx) = FIXED;
+			}
+		}
+		if (!valid)
+			skip_line(rd);
+	}
+	else {
+		*m = token_value(tok, len);
+		tok = line_token(rd, &len); /*the header is one line*/
+		*n = tok != NULL ? token_value(tok, len) : 0;
+		if (*m < 1 || *n < 1 || *m > MAX_N / *n) {
+			skip_line(rd);
+			return -1;
+		}
+		if (!prepare_board(board, *m, *n, alloc_secs))
+			return -1;
+		N = *m**n;
+		*count_hid = N*N;
+		for (idx = 0; idx < N*N && (tok = next_token(rd, &len)) != NULL; idx++) {
+			dig = token_value(tok, len);
+			if (dig < 0 || dig > N)
+				valid = 0;
+			else if (dig != 0) {
+				*count_hid -= 1;
+				NUM_AT((*board),idx) = dig;
+				if (fixed && tok[len-1] == '.')
+					STAT_AT((*board),idx) = FIXED;
+			}
+		}
+	}
+	build_board_index(*board); /*marks the cells ERRONEOUS, SHOWN or HIDDEN*/
+	return valid ? 1 : -1;
+}
 
 /**
 * parse_file - The function parses a file and creates a board according to it and to the game's mode.
+* the file is mapped to memory (see map_file) and its first board is read with read_board into a new board, which
+* replaces the game's board only if it is valid - otherwise the game's board and dimensions are left as they were.
+* the time of reading the board, without allocating it, is printed when load_stats is set.
 * @param
 * fp - the file we are reading from
 * board - pointer to the game board
@@ -97,167 +442,354 @@ int read_args(char** parsed_command, int args_num, double* x, double* y, double*
 * mark_errors - indicates whether errors should be marked
 * @return
 * 2 - board was properly loaded.
-* 0 - an error occured and we exit the game.
+* 3 - the file does not contain a valid board.
+* 0 - reading the file failed and we exit the game.
 */
-int parse_file (FILE* fp, Num**** board, int* m, int* n, int* count_hid, MODE mode, int mark_errors){
-	char file_content [COMMAND_LEN];
-	char* read_tok;
-	int row = 0; int col = 0;
-	int N; int dig; int valid;
-	int count = -2; /*count the numbers on board */
-	if (*board != NULL) {
-		free_board(board,*m**n);
-		*board = NULL;
-	}
-	while (fgets(file_content, COMMAND_LEN, fp) != NULL) {
-		read_tok = strtok(file_content, DELIMITERS);
-		while (read_tok != NULL) {
-			if (count==-2)
-				*m = atoi(read_tok);
-			else if (count==-1)
-				*n = atoi(read_tok);
-			else if (count >= 0){
-				if (count == 0) { /*initialization of board*/
-					N = *n**m;
-					*count_hid = N*N;
-					*board = create_empty_board (*m, *n);
-				}
-				row = count/N;
-				col = count%N;
-				dig = atoi(read_tok);
-				if (dig != 0) {
-					*count_hid -= 1;
-					valid = validate_dig(dig,row,col,*m,*n,N,*board,1,1);
-					if (read_tok[strlen(read_tok)-1] == '.' && mode == SOLVE)
-						(*board)[row][col]->status = FIXED;
-					else if ( valid == 0)
-						(*board)[row][col]->status = ERRONEOUS;
-					else
-						(*board)[row][col]->status = SHOWN;
-					(*board)[row][col]->num = dig;
-				}
-			}
-			count++;
-			read_tok = strtok(NULL, DELIMITERS);
-		}
-	}
-	if (ferror(fp)) { /* fgets error*/
-		printf("Error: fgets has failed\n");
+int parse_file (FILE* fp, Board** board, int* m, int* n, int* count_hid, MODE mode, int mark_errors){
+	TokenReader rd; int mapped; int res; Board* loaded = NULL; int loaded_m; int loaded_n; int loaded_hid;
+	struct timespec since; double secs; double alloc_secs = 0;
+	clock_gettime(CLOCK_MONOTONIC, &since);
+	rd.fp = NULL; /*the whole file is in the buffer*/
+	rd.eof = 1;
+	rd.pos = 0;
+	rd.buf = map_file(fp, &rd.len, &mapped);
+	rd.cap = rd.len;
+	if (rd.buf == NULL && ferror(fp)) {
+		printf("Error: reading the file has failed\n");
 		return 0;
 	}
+	res = read_board(&rd, &loaded, &loaded_m, &loaded_n, &loaded_hid, mode == SOLVE, &alloc_secs);
+	secs = seconds_since(&since) - alloc_secs;
+	if (mapped)
+		munmap(rd.buf, rd.len);
+	else
+		free(rd.buf);
+	if (res != 1) {
+		free_board(&loaded);
+		printf("Error: the file does not contain a valid board\n");
+		return 3;
+	}
+	free_board(board);
+	*board = loaded;
+	*m = loaded_m;
+	*n = loaded_n;
+	*count_hid = loaded_hid;
 	print_board (*board,*m,*n,mode,mark_errors);
+	if (load_stats)
+		print_load_stats((long) rd.len, secs);
 	return 2;
 }
 
 /**
- * check_command_length - checks that the command is of legal value, if not, parses the command until it ends,
- * that is - we reach a new line or the end of file.
+ * Type represents the id of a command, which get_command dispatches on.
+ */
+typedef enum command_id {
+	CMD_SOLVE, CMD_EDIT, CMD_MARK_ERRORS, CMD_PRINT_BOARD, CMD_SET, CMD_VALIDATE, CMD_GENERATE, CMD_UNDO, CMD_REDO,
+	CMD_SAVE, CMD_SAVE_BIN, CMD_HINT, CMD_HINT_ALL, CMD_NUM_SOLUTIONS, CMD_AUTOFILL, CMD_RESET, CMD_EXIT
+} CMD;
+
+/**
+ * Type represents the type of the arguments of a command.
+ */
+typedef enum arg_type {
+	ARG_NONE, /*no arguments*/
+	ARG_INT, /*integers, -1 for a token which isn't an integer - the command reports it as out of range*/
+	ARG_WORD, /*a word, such as a path*/
+	ARG_OPT_WORD, /*a word which may be left out*/
+	ARG_OPT_COUNT /*a positive integer which may be left out*/
+} ARG;
+
+/**
+ * Type represents a command of the game - its name, its id, and the number and type of its arguments.
+ */
+typedef struct command_desc {
+	char* name;
+	CMD id;
+	int args;
+	ARG type;
+} CommandDesc;
+
+/**
+ * Type represents the arguments of a command after they were read.
+ */
+typedef struct command_args {
+	int num[3];
+	char* word;
+} CommandArgs;
+
+CommandDesc commands[] = {
+	{"solve", CMD_SOLVE, 1, ARG_WORD},
+	{"edit", CMD_EDIT, 1, ARG_OPT_WORD},
+	{"mark_errors", CMD_MARK_ERRORS, 1, ARG_INT},
+	{"print_board", CMD_PRINT_BOARD, 0, ARG_NONE},
+	{"set", CMD_SET, 3, ARG_INT},
+	{"validate", CMD_VALIDATE, 0, ARG_NONE},
+	{"generate", CMD_GENERATE, 2, ARG_INT},
+	{"undo", CMD_UNDO, 1, ARG_OPT_COUNT},
+	{"redo", CMD_REDO, 1, ARG_OPT_COUNT},
+	{"save", CMD_SAVE, 1, ARG_WORD},
+	{"save_bin", CMD_SAVE_BIN, 1, ARG_WORD},
+	{"hint", CMD_HINT, 2, ARG_INT},
+	{"hint_all", CMD_HINT_ALL, 0, ARG_NONE},
+	{"num_solutions", CMD_NUM_SOLUTIONS, 1, ARG_OPT_COUNT},
+	{"autofill", CMD_AUTOFILL, 0, ARG_NONE},
+	{"reset", CMD_RESET, 0, ARG_NONE},
+	{"exit", CMD_EXIT, 0, ARG_NONE}
+};
+int command_slots[CMD_SLOTS]; /*open addressing hash table of the commands - index in commands+1, 0 for a free slot*/
+int commands_hashed = 0; /*set once command_slots was filled*/
+
+/**
+ * command_hash - hashes the name of a command into a slot of command_slots (djb2).
+ * @param
+ * name - the name
+ * @return
+ * the slot
+ */
+int command_hash(char* name) {
+	unsigned long h = 5381;
+	while (*name)
+		h = h*33 + (unsigned char) *name++;
+	return (int) (h & (CMD_SLOTS-1));
+}
+
+/**
+ * find_command - looks a command up by its name in the hash table of the commands, which is filled on the first call.
+ * a lookup takes one hash of the name and a string comparison for each command in its probe sequence, usually one.
  * @param
- * user_command - user's command
+ * name - the name
  * @return
- * 1 - if command is of valid length
+ * the command, NULL if there is no such command
+ */
+CommandDesc* find_command(char* name) {
+	int i; int slot; int count = (int) (sizeof(commands)/sizeof(commands[0]));
+	if (!commands_hashed) {
+		for (i = 0; i < count; i++) {
+			for (slot = command_hash(commands[i].name); command_slots[slot] != 0; slot = (slot+1) & (CMD_SLOTS-1))
+				;
+			command_slots[slot] = i+1;
+		}
+		commands_hashed = 1;
+	}
+	for (slot = command_hash(name); command_slots[slot] != 0; slot = (slot+1) & (CMD_SLOTS-1)) {
+		if (!strcmp(commands[command_slots[slot]-1].name, name))
+			return &commands[command_slots[slot]-1];
+	}
+	return NULL;
+}
+
+/**
+ * command_id - finds the number of a command, such as for keeping statistics of every command.
+ * @param
+ * name - the name of the command
+ * @return
+ * number of the command, 0..command_count()-1, -1 if there is no such command
+ */
+int command_id(char* name) {
+	CommandDesc* desc = find_command(name);
+	return desc != NULL ? (int) (desc - commands) : -1;
+}
+
+/**
+ * command_count - returns the number of commands.
+ * @return
+ * the number of commands
+ */
+int command_count() {
+	return (int) (sizeof(commands)/sizeof(commands[0]));
+}
+
+/**
+ * command_name - returns the name of a command by its number (see command_id).
+ * @param
+ * id - number of the command
+ * @return
+ * the name
+ */
+char* command_name(int id) {
+	return commands[id].name;
+}
+
+/**
+ * arg_int - reads an integer argument. a fraction of zeros, such as in "3.0", is accepted.
+ * @param
+ * tok - the token of the argument
+ * @return
+ * the integer, -1 if the token isn't an integer or is out of the range of int
+ */
+int arg_int(char* tok) {
+	char* end; long val = strtol(tok, &end, 10);
+	if (end == tok || val > INT_MAX || val < INT_MIN)
+		return -1;
+	if (*end == '.')
+		while (*++end == '0')
+			;
+	return *end == '\0' ? (int) val : -1;
+}
+
+/**
+ * read_command_args - reads the arguments of a command from the rest of its tokens (see strtok), by its descriptor.
+ * extra tokens are ignored. prints an error message if an argument is missing or an optional count isn't legal.
+ * @param
+ * desc - the command
+ * args - the arguments, set by the function
+ * @return
+ * 1 - if the arguments are legal
  * 0 - otherwise
  */
-int check_command_length(char user_command[]) {
-	int valid_command = 1;
-	int ch;
-	if (strlen(user_command) == COMMAND_LEN && user_command[COMMAND_LEN - 2] != '\n') {
-	    while ((ch = fgetc(stdin)) != '\n' && ch != EOF) { /*get rid of the rest of command*/
-	    	valid_command = 0;
-	    }
+int read_command_args(CommandDesc* desc, CommandArgs* args) {
+	int i; char* tok;
+	args->word = NULL;
+	args->num[0] = desc->id == CMD_NUM_SOLUTIONS ? 0 : 1; /*the default count - all solutions, or one move*/
+	for (i = 0; i < desc->args; i++) {
+		tok = strtok(NULL,DELIMITERS);
+		if (tok == NULL) {
+			if (desc->type == ARG_OPT_WORD || desc->type == ARG_OPT_COUNT)
+				return 1;
+			print_invalid();
+			return 0;
+		}
+		if (desc->type == ARG_WORD || desc->type == ARG_OPT_WORD)
+			args->word = tok;
+		else if ((args->num[i] = arg_int(tok)) < 1 && desc->type == ARG_OPT_COUNT) {
+			print_invalid();
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * run_command - reads the arguments of one command and calls it.
+ * @param
+ * tok - the name of the command, the first token of the command (see strtok)
+ * (the rest as in get_command)
+ * @return
+ * as returned by the command, or 3 for an unknown command or illegal arguments
+ */
+int run_command(char* tok, Board** board, int* m, int* n, int* count_hid, MODE* mode, int* mark_errors,
+		MoveList** curr_move) {
+	CommandArgs args; CommandDesc* desc = find_command(tok);
+	if (desc == NULL) {
+		print_invalid();
+		return 3;
+	}
+	if (!read_command_args(desc, &args))
+		return 3;
+	switch (desc->id) {
+	case CMD_SOLVE:
+		return solve(args.word,board,mode,curr_move,m,n,count_hid,*mark_errors);
+	case CMD_EDIT:
+		return edit(args.word,board,mode,curr_move,m,n,count_hid);
+	case CMD_MARK_ERRORS:
+		return change_mark_errors(args.num[0], *mode, mark_errors);
+	case CMD_PRINT_BOARD:
+		return print_board(*board, *m, *n, *mode, *mark_errors);
+	case CMD_SET:
+		return set(args.num[0]-1,args.num[1]-1,args.num[2],*board,*m,*n,count_hid,mode,curr_move,*mark_errors);
+	case CMD_VALIDATE:
+		return validate(*board, *m, *n, *mode, 1);
+	case CMD_GENERATE:
+		return generate(*board,*m, *n, args.num[0], args.num[1], *mode, count_hid, curr_move);
+	case CMD_UNDO:
+		return undo(*mode,curr_move,*board,count_hid,*m,*n, *mark_errors, args.num[0]);
+	case CMD_REDO:
+		return redo(*mode,curr_move,*board,count_hid,*m,*n, *mark_errors, args.num[0]);
+	case CMD_SAVE:
+		return save(*board,args.word,*m,*n,*mode);
+	case CMD_SAVE_BIN:
+		return save_bin(*board,args.word,*m,*n,*mode);
+	case CMD_HINT:
+		return hint(*board,args.num[0]-1, args.num[1]-1,*m, *n, *mode);
+	case CMD_HINT_ALL:
+		return hint_all(*board,*m,*n,*mode);
+	case CMD_NUM_SOLUTIONS:
+		return num_of_solutions(*board,*m,*n,*count_hid,*mode,(long) args.num[0]);
+	case CMD_AUTOFILL:
+		return autofill(*board,*m,*n,mode,count_hid,curr_move,*mark_errors);
+	case CMD_RESET:
+		return reset(*board,curr_move,*mode,count_hid,*m,*n, *mark_errors);
+	case CMD_EXIT:
+		return !exit_game(board, curr_move);
+	}
+	return 3;
+}
+
+/**
+ * read_line - reads a line of any length from a stream, into a buffer that grows as needed.
+ * @param
+ * fp - the stream
+ * @return
+ * the line, with its newline if it has one, to be freed by the caller. NULL at the end of the stream, or if reading
+ * or memory allocation failed
+ */
+char* read_line(FILE* fp) {
+	size_t cap = LINE_START; size_t len = 0; char* line = malloc(cap); char* bigger;
+	if (!line)
+		return NULL;
+	while (fgets(line+len, (int) (cap-len), fp) != NULL) {
+		len += strlen(line+len);
+		if (line[len-1] == '\n')
+			return line;
+		if (len+1 == cap) { /*the buffer is full, the line goes on*/
+			if (!(bigger = realloc(line, 2*cap)))
+				break;
+			line = bigger;
+			cap *= 2;
+		}
 	}
-	return valid_command;
+	if (len > 0 && !ferror(fp))
+		return line; /*the last line, without a newline*/
+	free(line);
+	return NULL;
 }
 
 /**
-* get_command -  parses through user's command using fgets and strtok.
-* function checks if we reached EOF, if so calls exit_game.
-* function checks if command is valid, and executes it if so.
-* if command isn't valid, function prints error message.
+ * split_command - takes the next command of a line of commands separated by ';', and ends it in place.
+ * @param
+ * rest - pointer to the rest of the line, set to after the command, or to NULL after the last one
+ * @return
+ * the command
+ */
+char* split_command(char** rest) {
+	char* cmd = *rest;
+	if ((*rest = strchr(cmd, ';')) != NULL) /*the command ends before the next one*/
+		*(*rest)++ = '\0';
+	return cmd;
+}
+
+/**
+* get_command - reads a line of the user's input and runs its commands. a line may be of any length, and may hold
+* several commands separated by ';', which run one after the other - a script can send many commands in one write.
+* every command is looked up in a hash table of the commands, and its arguments are read by its descriptor (see
+* run_command). function checks if we reached EOF, if so calls exit_game.
+* if a command isn't valid, function prints error message and goes on to the next one.
 * @param board - the game board
 * @param n - number of rows in one block
 * @param m - number of columns in one block
 * @param count_hid - number of hidden cells on board
 * @return
 * 0 - if we exit the game
-* 2 - if a command has been executed
-* 3 - otherwise, meaning got an invalid command
+* 2 - if the last command of the line has been executed
+* 3 - otherwise, meaning it was invalid, or the line was empty
 */
-int get_command (Num**** board, int* m,int* n, int* count_hid, MODE* mode, int* mark_errors, MoveList** curr_move) {
-	char user_command [COMMAND_LEN];
-	double x = 0; double y = 0; double z = 0;
-	char* parsed_command;
+int get_command (Board** board, int* m,int* n, int* count_hid, MODE* mode, int* mark_errors, MoveList** curr_move) {
+	char* line; char* rest; char* tok; int res = 3;
 	printf("Enter your command:\n");
-	if (fgets(user_command, COMMAND_LEN+1, stdin) == NULL) { /*read command*/
+	fflush(stdout); /*the output of the last command and the prompt are written at once (see main)*/
+	if ((line = read_line(stdin)) == NULL) { /*read command*/
 		if (feof(stdin)) /*end of file*/
-			return (!exit_game(board,*n**m, curr_move));
+			return (!exit_game(board, curr_move));
 		else {
-			printf("Error: fgets has failed\n");
+			printf("Error: reading the command has failed\n");
 			return 3;
 		}
 	}
-	if (!check_command_length(user_command)) {
-		print_invalid();
-		return 3;
+	for (rest = line; rest != NULL && res != 0; ) {
+		tok = strtok(split_command(&rest),DELIMITERS); /*parse command*/
+		if (tok != NULL) /*got a word, otherwise the command is empty*/
+			res = run_command(tok, board, m, n, count_hid, mode, mark_errors, curr_move);
 	}
-	parsed_command = strtok(user_command,DELIMITERS); /*parse command*/
-	if (parsed_command != NULL) { /*got a word*/
-		if (!strcmp(parsed_command,"validate"))
-			return validate(*board, *m, *n, *mode, 1);
-		else if (!strcmp(parsed_command,"reset"))
-			return reset(*board,curr_move,*mode,count_hid,*m,*n, *mark_errors);
-		else if (!strcmp(parsed_command,"hint")) {
-			if (!read_args(&parsed_command, 2, &x,&y,&z,"hint"))
-				return 3;
-			return hint(*board,(int) x-1, (int) y-1,*m, *n, *mode);
-		}
-		else if (!strcmp(parsed_command,"set"))  {
-			if (!read_args(&parsed_command, 3, &x,&y,&z,"set"))
-				return 3;
-			return(set((int) x-1,(int) y-1, (int) z,*board,*m,*n,count_hid,mode,curr_move,*mark_errors));
-		}
-		else if (!strcmp(parsed_command,"solve")) {
-			if (!read_args(&parsed_command, 1, &x,&y,&z,"solve"))
-				return 3;
-			return solve(parsed_command,board,mode,curr_move,m,n,count_hid,*mark_errors);
-		}
-		else if (!strcmp(parsed_command,"edit")) {
-			parsed_command = strtok(NULL,DELIMITERS);
-			return edit(parsed_command,board,mode,curr_move,m,n,count_hid);
-		}
-		else if (!strcmp(parsed_command,"save")) {
-			if (!read_args(&parsed_command, 1, &x,&y,&z,"save"))
-				return 3;
-			return save(*board,parsed_command,*m,*n,*mode);
-		}
-		else if (!strcmp(parsed_command,"generate")) {
-			if (!read_args(&parsed_command, 2, &x,&y,&z,"gen"))
-				return 3;
-			return generate(*board,*m, *n, (int) x, (int) y, *mode, count_hid, curr_move);
-		}
-		else if (!strcmp(parsed_command,"autofill"))
-			return (autofill(*board,*m,*n,mode,count_hid,curr_move,*mark_errors));
-		else if (!strcmp(parsed_command,"mark_errors")) {
-			if (!read_args(&parsed_command, 1, &x,&y,&z,"mark_errors"))
-				return 3;
-			return change_mark_errors(x, *mode, mark_errors);
-		}
-		else if (!strcmp(parsed_command,"print_board"))
-			return print_board(*board, *m, *n, *mode, *mark_errors);
-		else if (!strcmp(parsed_command,"undo"))
-			return (undo (*mode,curr_move,*board,count_hid,*m,*n, *mark_errors, 1));
-		else if (!strcmp(parsed_command,"redo"))
-			return (redo (*mode,curr_move,*board,count_hid,*m,*n, *mark_errors));
-		else if (!strcmp(parsed_command,"num_solutions"))
-			return num_of_solutions(*board,*m,*n,*count_hid,*mode);
-		else if (!strcmp(parsed_command,"exit"))
-			return (!exit_game(board,*n**m, curr_move));
-		else {
-			print_invalid();
-			return 3;
-		}
-	}
-	if (!isspace(user_command[0])) /*could get here for a space which is not an invalid command */
-		print_invalid();
-	return 3;
+	free(line);
+	return res;
 }
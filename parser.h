@@ -5,13 +5,43 @@
 * supports the following functions:
 *
 * parse_file - The function parses a file and creates a board according to it and to the game's mode.
-* get_command - parses through the user's input, calls the relevant command or prints an error message.
+* map_file - gives the content of a file in memory, mapped with mmap when possible.
+* read_board - reads the next board of a file or a stream, in the format save writes or in one line.
+* get_command - reads a line of the user's input and runs its commands, separated by ';', or prints an error message.
+* read_line - reads a line of any length from a stream.
+* split_command - takes the next command of a line of commands separated by ';'.
+* run_command - reads the arguments of one command and calls it.
+* command_id - finds the number of a command by its name.
+* command_count - returns the number of commands.
+* command_name - returns the name of a command by its number.
+* set_load_stats - sets whether loading a board prints the file's size and the parse throughput.
+* seconds_since - measures the time that passed since a given time.
 *
 */
 
-extern int parse_file (FILE* fp, Num**** board, int* m, int* n, int* count_hid, MODE mode, int mark_errors);
+struct timespec;
 
-extern int get_command (Num**** board, int* m,int* n, int* count_hid, MODE* mode, int* mark_errors, MoveList** curr_move);
+extern int parse_file (FILE* fp, Board** board, int* m, int* n, int* count_hid, MODE mode, int mark_errors);
 
+extern char* map_file(FILE* fp, size_t* len, int* mapped);
 
+extern int read_board(TokenReader* rd, Board** board, int* m, int* n, int* count_hid, int fixed, double* alloc_secs);
 
+extern int get_command (Board** board, int* m,int* n, int* count_hid, MODE* mode, int* mark_errors, MoveList** curr_move);
+
+extern char* read_line(FILE* fp);
+
+extern char* split_command(char** rest);
+
+extern int run_command(char* tok, Board** board, int* m, int* n, int* count_hid, MODE* mode, int* mark_errors,
+		MoveList** curr_move);
+
+extern int command_id(char* name);
+
+extern int command_count();
+
+extern char* command_name(int id);
+
+extern void set_load_stats(int on);
+
+extern double seconds_since(struct timespec* since);
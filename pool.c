@@ -0,0 +1,254 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "structs.h"
+#include "pool.h"
+
+
+/**
+ * Type represents the tasks left for one worker - the range [first, last) of task indices.
+ * the owner takes tasks from the front of its range, thieves take them from the back.
+ */
+typedef struct task_range {
+	int first;
+	int last;
+	pthread_mutex_t lock;
+} TaskRange;
+
+/**
+ * Type represents a running pool - the ranges of all workers and the work to do.
+ */
+typedef struct pool {
+	TaskRange* ranges;
+	int threads;
+	void (*work)(void* arg, int task, int worker);
+	void* arg;
+} Pool;
+
+/**
+ * Type represents the argument of one worker thread.
+ */
+typedef struct worker_arg {
+	Pool* pool;
+	int id;
+} WorkerArg;
+
+
+/**
+ * take_own - takes the next task from the front of a worker's own range.
+ * @param
+ * range - the worker's range
+ * @return
+ * index of the task, -1 if the range is empty
+ */
+int take_own(TaskRange* range) {
+	int task = -1;
+	pthread_mutex_lock(&range->lock);
+	if (range->first < range->last)
+		task = range->first++;
+	pthread_mutex_unlock(&range->lock);
+	return task;
+}
+
+/**
+ * steal - takes a task from the back of the range of some other worker, starting with the worker after the thief.
+ * @param
+ * pool - the pool
+ * thief - index of the stealing worker
+ * @return
+ * index of the task, -1 if all ranges are empty
+ */
+int steal(Pool* pool, int thief) {
+	int i; int task = -1; TaskRange* victim;
+	for (i = 1; i < pool->threads && task < 0; i++) {
+		victim = &pool->ranges[(thief + i) % pool->threads];
+		pthread_mutex_lock(&victim->lock);
+		if (victim->first < victim->last)
+			task = --victim->last;
+		pthread_mutex_unlock(&victim->lock);
+	}
+	return task;
+}
+
+/**
+ * worker_main - runs tasks until no worker has tasks left.
+ * @param
+ * p - pointer to the WorkerArg of this worker
+ */
+void* worker_main(void* p) {
+	WorkerArg* warg = (WorkerArg*) p;
+	Pool* pool = warg->pool;
+	int task;
+	while ((task = take_own(&pool->ranges[warg->id])) >= 0 || (task = steal(pool, warg->id)) >= 0)
+		pool->work(pool->arg, task, warg->id);
+	return NULL;
+}
+
+/**
+ * run_pool - runs tasks 0..ntasks-1 on the given number of threads, and waits for all of them to finish.
+ * the tasks are split into equal contiguous ranges, one per thread. the calling thread serves as worker 0.
+ * @param
+ * threads - number of threads to use, including the calling thread
+ * ntasks - number of tasks
+ * work - function which runs one task, given arg, the index of the task and the index of the worker running it
+ * arg - argument passed to work
+ * @return
+ * 1 - on success
+ * 0 - if the pool could not be created (no task was run)
+ */
+int run_pool(int threads, int ntasks, void (*work)(void* arg, int task, int worker), void* arg) {
+	Pool pool; WorkerArg* wargs; pthread_t* tids; int i; int started;
+	if (threads > ntasks)
+		threads = ntasks;
+	if (threads <= 1) { /*no need for threads*/
+		for (i = 0; i < ntasks; i++)
+			work(arg, i, 0);
+		return 1;
+	}
+	pool.threads = threads;
+	pool.work = work;
+	pool.arg = arg;
+	pool.ranges = malloc(threads*sizeof(TaskRange));
+	wargs = malloc(threads*sizeof(WorkerArg));
+	tids = malloc(threads*sizeof(pthread_t));
+	if (!pool.ranges || !wargs || !tids) {
+		free(pool.ranges);
+		free(wargs);
+		free(tids);
+		return 0;
+	}
+	for (i = 0; i < threads; i++) {
+		pool.ranges[i].first = (int) ((long) ntasks*i/threads);
+		pool.ranges[i].last = (int) ((long) ntasks*(i+1)/threads);
+		pthread_mutex_init(&pool.ranges[i].lock, NULL);
+		wargs[i].pool = &pool;
+		wargs[i].id = i;
+	}
+	for (started = 1; started < threads; started++) {
+		if (pthread_create(&tids[started], NULL, worker_main, &wargs[started]) != 0)
+			break; /*the workers that did start steal the tasks of the others*/
+	}
+	worker_main(&wargs[0]);
+	for (i = 1; i < started; i++)
+		pthread_join(tids[i], NULL);
+	for (i = 0; i < threads; i++)
+		pthread_mutex_destroy(&pool.ranges[i].lock);
+	free(pool.ranges);
+	free(wargs);
+	free(tids);
+	return 1;
+}
+
+/**
+ * online_cores - returns the number of online processors of the host.
+ * @return
+ * number of processors, 1 if it can't be determined
+ */
+int online_cores() {
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	return cores < 1 ? 1 : (int) cores;
+}
+
+/**
+ * init_queue - creates an empty bounded queue. the capacity is rounded up to a power of 2.
+ * the queue is lock-free - any number of threads may push and pop at the same time, each cell carries a sequence
+ * number which tells whether it is free for the push of a given round or holds the value for the pop of that round.
+ * @param
+ * q - the queue
+ * size - minimal number of values the queue holds
+ * @return
+ * 1 - on success
+ * 0 - if memory allocation failed
+ */
+int init_queue(RingQueue* q, int size) {
+	unsigned long cap = 1; unsigned long i;
+	while (cap < (unsigned long) size)
+		cap *= 2;
+	q->cells = malloc(cap*sizeof(RingCell));
+	if (!q->cells)
+		return 0;
+	for (i = 0; i < cap; i++)
+		q->cells[i].seq = i;
+	q->mask = cap-1;
+	q->head = q->tail = 0;
+	q->max_depth = 0;
+	return 1;
+}
+
+/**
+ * free_queue - frees the cells of a queue.
+ * @param
+ * q - the queue
+ */
+void free_queue(RingQueue* q) {
+	free(q->cells);
+	q->cells = NULL;
+}
+
+/**
+ * queue_push - adds a value at the tail of a queue.
+ * @param
+ * q - the queue
+ * val - the value
+ * @return
+ * 1 - if the value was added
+ * 0 - if the queue is full
+ */
+int queue_push(RingQueue* q, long val) {
+	RingCell* cell; unsigned long pos = __sync_fetch_and_add(&q->tail, 0); long dif; long max;
+	for (;;) {
+		cell = &q->cells[pos & q->mask];
+		dif = (long) (__sync_fetch_and_add(&cell->seq, 0) - pos);
+		if (dif == 0 && __sync_bool_compare_and_swap(&q->tail, pos, pos+1))
+			break;
+		if (dif < 0) /*the cell still holds the value of the previous round*/
+			return 0;
+		pos = __sync_fetch_and_add(&q->tail, 0);
+	}
+	cell->val = val;
+	__sync_synchronize();
+	__sync_lock_test_and_set(&cell->seq, pos+1); /*ready to be popped*/
+	dif = (long) (pos+1 - __sync_fetch_and_add(&q->head, 0));
+	max = __sync_fetch_and_add(&q->max_depth, 0);
+	while (dif > max && !__sync_bool_compare_and_swap(&q->max_depth, max, dif))
+		max = __sync_fetch_and_add(&q->max_depth, 0);
+	return 1;
+}
+
+/**
+ * queue_pop - removes the value at the head of a queue.
+ * @param
+ * q - the queue
+ * val - pointer to the removed value, set by the function
+ * @return
+ * 1 - if a value was removed
+ * 0 - if the queue is empty
+ */
+int queue_pop(RingQueue* q, long* val) {
+	RingCell* cell; unsigned long pos = __sync_fetch_and_add(&q->head, 0); long dif;
+	for (;;) {
+		cell = &q->cells[pos & q->mask];
+		dif = (long) (__sync_fetch_and_add(&cell->seq, 0) - (pos+1));
+		if (dif == 0 && __sync_bool_compare_and_swap(&q->head, pos, pos+1))
+			break;
+		if (dif < 0) /*nothing was pushed to the cell in this round*/
+			return 0;
+		pos = __sync_fetch_and_add(&q->head, 0);
+	}
+	*val = cell->val;
+	__sync_synchronize();
+	__sync_lock_test_and_set(&cell->seq, pos + q->mask + 1); /*free for the push of the next round*/
+	return 1;
+}
+
+/**
+ * queue_depth - counts the values in a queue. the count is exact only when no thread uses the queue.
+ * @param
+ * q - the queue
+ * @return
+ * number of values in the queue
+ */
+long queue_depth(RingQueue* q) {
+	return (long) (__sync_fetch_and_add(&q->tail, 0) - __sync_fetch_and_add(&q->head, 0));
+}
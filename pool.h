@@ -0,0 +1,31 @@
+/**
+* pool Summary:
+* A work-stealing thread pool. Runs a set of independent tasks on a number of threads - each thread starts with its own
+* share of the tasks, and threads that run out of work steal tasks from the others.
+* Also provides bounded lock-free queues, for passing work between threads that run different stages.
+*
+* supports the following functions:
+*
+* run_pool - runs all tasks on the given number of threads and waits for them to finish.
+* online_cores - returns the number of online processors of the host.
+* init_queue - creates an empty bounded lock-free queue.
+* free_queue - frees the cells of a queue.
+* queue_push - adds a value at the tail of a queue, unless it is full.
+* queue_pop - removes the value at the head of a queue, unless it is empty.
+* queue_depth - counts the values in a queue.
+*
+*/
+
+extern int run_pool(int threads, int ntasks, void (*work)(void* arg, int task, int worker), void* arg);
+
+extern int online_cores();
+
+extern int init_queue(RingQueue* q, int size);
+
+extern void free_queue(RingQueue* q);
+
+extern int queue_push(RingQueue* q, long val);
+
+extern int queue_pop(RingQueue* q, long* val);
+
+extern long queue_depth(RingQueue* q);
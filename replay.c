@@ -0,0 +1,188 @@
+#define _POSIX_C_SOURCE 200112L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "structs.h"
+#include "parser.h"
+#include "game.h"
+#include "main_aux.h"
+#define DELIMITERS " \n\t\v\f\r"
+#define FIRST_LATENCIES 64 /*first size of the array of latencies of a command*/
+
+char* replay_input = NULL; /*script of commands to replay, NULL when not replaying*/
+int replay_echo = 0; /*whether the output of the replayed commands is written*/
+
+/**
+ * Type represents the latencies of one command in a replay.
+ */
+typedef struct latencies {
+	double* secs; /*the latency of every run of the command, in seconds*/
+	long count;
+	long cap;
+	long errors; /*runs that returned an error*/
+} Latencies;
+
+/**
+ * set_replay_input - sets the script of commands to replay, and turns on replay mode.
+ * @param
+ * path - path of the script, "-" for the standard input
+ */
+void set_replay_input(char* path) {
+	replay_input = path;
+}
+
+/**
+ * set_replay_echo - sets whether the output of the replayed commands is written to the standard output.
+ * @param
+ * on - 1 to write it, 0 to discard it (the default)
+ */
+void set_replay_echo(int on) {
+	replay_echo = on;
+}
+
+/**
+ * replay_mode - checks whether replay mode was selected.
+ * @return
+ * 1 - if a script was set with set_replay_input
+ * 0 - otherwise
+ */
+int replay_mode() {
+	return replay_input != NULL;
+}
+
+/**
+ * add_latency - records one run of a command.
+ * @param
+ * lat - the latencies of the command
+ * secs - the latency of the run, in seconds
+ * res - what the command returned
+ * @return
+ * 1 - on success
+ * 0 - if memory allocation failed
+ */
+int add_latency(Latencies* lat, double secs, int res) {
+	double* bigger;
+	if (lat->count == lat->cap) {
+		bigger = realloc(lat->secs, (lat->cap ? 2*lat->cap : FIRST_LATENCIES)*sizeof(double));
+		if (!bigger)
+			return 0;
+		lat->secs = bigger;
+		lat->cap = lat->cap ? 2*lat->cap : FIRST_LATENCIES;
+	}
+	lat->secs[lat->count++] = secs;
+	if (res == 3)
+		lat->errors++;
+	return 1;
+}
+
+/**
+ * compare_secs - compares two latencies, for qsort.
+ * @param
+ * a - pointer to the first latency
+ * b - pointer to the second latency
+ * @return
+ * negative, 0 or positive - if the first is smaller than, equal to or larger than the second
+ */
+int compare_secs(const void* a, const void* b) {
+	double x = *(const double*) a; double y = *(const double*) b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * percentile - finds a percentile of sorted latencies, by the nearest rank.
+ * @param
+ * secs - the latencies, sorted
+ * count - number of latencies, at least 1
+ * p - the percentile, 0..100
+ * @return
+ * the latency at the percentile
+ */
+double percentile(double* secs, long count, double p) {
+	long rank = (long) (p/100*count + 0.999999);
+	return secs[rank < 1 ? 0 : rank-1];
+}
+
+/**
+ * report_latencies - sorts the latencies of a command and prints their count, mean and percentiles.
+ * @param
+ * name - name of the command
+ * lat - its latencies
+ */
+void report_latencies(char* name, Latencies* lat) {
+	double total = 0; long i;
+	if (lat->count == 0)
+		return;
+	qsort(lat->secs, lat->count, sizeof(double), compare_secs);
+	for (i = 0; i < lat->count; i++)
+		total += lat->secs[i];
+	print_latency_row(name, lat->count, lat->errors, total/lat->count, percentile(lat->secs, lat->count, 50),
+			percentile(lat->secs, lat->count, 90), percentile(lat->secs, lat->count, 99), lat->secs[lat->count-1]);
+}
+
+/**
+ * run_replay - runs the commands of a script one after the other, as get_command does but without the prompt, and
+ * measures the latency of every command. the script is read a line at a time, a line may hold several commands
+ * separated by ';', and lines starting with '#' are comments - so a recorded session or a generated script replays
+ * as is. the output of the commands is discarded unless echo was set (see set_replay_echo). at the end, the number
+ * of commands and their throughput, and the count, errors, mean and 50th, 90th and 99th percentiles and largest
+ * latency of every command are written to the standard error. the game is left as the script left it - exit_game is
+ * called if the script doesn't exit.
+ * @param
+ * (as in get_command)
+ * @return
+ * 0 - if the script was replayed
+ * 1 - if it could not be opened, or memory allocation failed
+ */
+int run_replay(Board** board, int* m, int* n, int* count_hid, MODE* mode, int* mark_errors, MoveList** curr_move) {
+	FILE* fp = stdin; char* line; char* rest; char* tok; int res = 2; int id; int kinds = command_count(); int ok = 1;
+	Latencies* lats; Latencies all; struct timespec since; struct timespec cmd_since; double secs; double lat;
+	if (strcmp(replay_input,"-") && !(fp = fopen(replay_input,"r"))) {
+		print_file_err_solve();
+		return 1;
+	}
+	if (!replay_echo && !freopen("/dev/null","w",stdout)) { /*the output is made, then discarded*/
+		if (fp != stdin)
+			fclose(fp);
+		return 1;
+	}
+	lats = calloc(kinds+1, sizeof(Latencies)); /*the last one for unknown commands*/
+	memset(&all, 0, sizeof(Latencies));
+	if (!lats) {
+		if (fp != stdin)
+			fclose(fp);
+		return 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &since);
+	while (res != 0 && ok && (line = read_line(fp)) != NULL) {
+		rest = line + strspn(line, DELIMITERS);
+		if (*rest == '#') /*a comment*/
+			rest = NULL;
+		while (rest != NULL && res != 0 && ok) {
+			tok = strtok(split_command(&rest),DELIMITERS);
+			if (tok == NULL)
+				continue;
+			id = command_id(tok);
+			clock_gettime(CLOCK_MONOTONIC, &cmd_since);
+			res = run_command(tok, board, m, n, count_hid, mode, mark_errors, curr_move);
+			lat = seconds_since(&cmd_since);
+			ok = add_latency(&lats[id < 0 ? kinds : id], lat, res) && add_latency(&all, lat, res);
+		}
+		free(line);
+	}
+	if (res != 0) /*the script didn't exit*/
+		exit_game(board, curr_move);
+	fflush(stdout);
+	secs = seconds_since(&since);
+	print_replay_stats(all.count, secs);
+	for (id = 0; id <= kinds; id++) {
+		report_latencies(id < kinds ? command_name(id) : "(invalid)", &lats[id]);
+		free(lats[id].secs);
+	}
+	report_latencies("all", &all);
+	free(all.secs);
+	free(lats);
+	if (fp != stdin)
+		fclose(fp);
+	return !ok;
+}
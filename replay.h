@@ -0,0 +1,21 @@
+/**
+* replay Summary:
+* Replays a script of commands through the game without the prompt, discarding their output, and reports the latency
+* of every command - a repeatable benchmark of the game engine. a recorded session replays as is.
+*
+* supports the following functions:
+*
+* set_replay_input - sets the script of commands to replay, and turns on replay mode.
+* set_replay_echo - sets whether the output of the replayed commands is written.
+* replay_mode - checks whether replay mode was selected.
+* run_replay - runs the commands of the script and writes their throughput and latency percentiles.
+*
+*/
+
+extern void set_replay_input(char* path);
+
+extern void set_replay_echo(int on);
+
+extern int replay_mode();
+
+extern int run_replay(Board** board, int* m, int* n, int* count_hid, MODE* mode, int* mark_errors, MoveList** curr_move);
@@ -1,6 +1,9 @@
+#ifndef NO_GUROBI
 #include "gurobi_c.h"
+#endif
 #include "structs.h"
 #include "struct_functions.h"
+#include "native_solver.h"
 #include "game.h"
 #include "main_aux.h"
 #include <time.h>
@@ -27,15 +30,15 @@
 * 0 - if validation failed
 * 1 - if validation succeeded
 */
-int validate_row(int dig, int row, int N, Num*** board, int change_err, int num_alt) {
+int validate_row(int dig, int row, int N, Board* board, int change_err, int num_alt) {
 	int col; int valid = 1;
 	for (col = 0; col < N; col++){
-		if ((board[row][col]->num == dig && num_alt) || (board[row][col]->alt_num == dig && !num_alt)) {
+		if ((CELL_NUM(board,row,col) == dig && num_alt) || (CELL_ALT(board,row,col) == dig && !num_alt)) {
 			if (!change_err) /*no need to continue, we already know the answer*/
 				return 0;
 			valid = 0; /*otherwise, we need to change the status to each erroneous cell*/
-			if (board[row][col]->status != FIXED && dig)
-				board[row][col]->status = ERRONEOUS;
+			if (CELL_STAT(board,row,col) != FIXED && dig)
+				CELL_STAT(board,row,col) = ERRONEOUS;
 		}
 	}
 	return valid;
@@ -58,16 +61,16 @@ int validate_row(int dig, int row, int N, Num*** board, int change_err, int num_
 * 0 - if validation failed
 * 1 - if validation succeeded
 */
-int validate_col(int dig, int col, int N, Num*** board, int change_err, int num_alt) {
+int validate_col(int dig, int col, int N, Board* board, int change_err, int num_alt) {
 	int row; int valid = 1;
 	for (row = 0; row < N; row++){
-		if ((board[row][col]->num == dig && num_alt) || (board[row][col]->alt_num == dig && !num_alt) ) {
+		if ((CELL_NUM(board,row,col) == dig && num_alt) || (CELL_ALT(board,row,col) == dig && !num_alt) ) {
 			if (!change_err) /*no need to continue, we already know the answer*/ {
 				return 0;
 			}
 			valid = 0; /*otherwise, we need to change the status to each erroneous cell*/
-			if (board[row][col]->status != FIXED) {
-				board[row][col]->status = ERRONEOUS;
+			if (CELL_STAT(board,row,col) != FIXED) {
+				CELL_STAT(board,row,col) = ERRONEOUS;
 			}
 		}
 	}
@@ -93,18 +96,18 @@ int validate_col(int dig, int col, int N, Num*** board, int change_err, int num_
 * 0 - if validation failed
 * 1 - if validation succeeded
 */
-int validate_block(int dig, int row, int col, int m, int n, Num*** board, int change_err, int num_alt) {
+int validate_block(int dig, int row, int col, int m, int n, Board* board, int change_err, int num_alt) {
 	int r_start = row - row % m;
 	int c_start = col - col % n;
 	int i; int j; int valid = 1;
 	for (i = 0; i < m; i++) {
 		for (j = 0; j < n; j++) {
-			if ((board[r_start+i][c_start+j]->num == dig && num_alt) || (board[r_start+i][c_start+j]->alt_num == dig && !num_alt)) {
+			if ((CELL_NUM(board,r_start+i,c_start+j) == dig && num_alt) || (CELL_ALT(board,r_start+i,c_start+j) == dig && !num_alt)) {
 				if (!change_err) /*no need to continue, we already know the answer*/
 					return 0;
 				valid = 0; /*otherwise, we need to change the status to each erroneous cell*/
-				if (board[r_start+i][c_start+j]->status != FIXED) {
-					board[r_start+i][c_start+j]->status = ERRONEOUS;
+				if (CELL_STAT(board,r_start+i,c_start+j) != FIXED) {
+					CELL_STAT(board,r_start+i,c_start+j) = ERRONEOUS;
 				}
 			}
 		}
@@ -114,6 +117,8 @@ int validate_block(int dig, int row, int col, int m, int n, Num*** board, int ch
 
 /**
 * function checks if a placement of a given digit in a given cell is valid, by calling the validation functions mentioned above.
+* when checking by num values, the board's constraint index answers in O(1), and the rows, columns and blocks are scanned
+* only if erroneous cells need to be marked.
 * @param dig - the checked digit
 * @param row - the cell's row
 * @param col - the cell's column
@@ -125,10 +130,16 @@ int validate_block(int dig, int row, int col, int m, int n, Num*** board, int ch
 * 0 - if one of the validations has failed
 * 1 - if all validations succeeded
 */
-int validate_dig (int dig, int row, int col, int m, int n, int N, Num*** board, int change_err, int num_alt) {
+int validate_dig (int dig, int row, int col, int m, int n, int N, Board* board, int change_err, int num_alt) {
 	int valid = 1;
 	if (dig == 0)
 		return 1;
+	if (num_alt) {
+		if (!dig_used(board,dig,row,col))
+			return 1;
+		if (!change_err) /*no need to find the erroneous cells*/
+			return 0;
+	}
 	if (!validate_row(dig, row, N, board,change_err,num_alt))
 		valid = 0;
 	if (!validate_col(dig, col, N, board,change_err, num_alt))
@@ -143,7 +154,7 @@ int validate_dig (int dig, int row, int col, int m, int n, int N, Num*** board,
 
 /**
 * function finds first empty cell on board by alt_num values.
-* iterates with pointers to row and col values until finds an index of which board[*row][*col]->alt_num == 0.
+* iterates with pointers to row and col values until finds an index of which CELL_ALT(board,*row,*col) == 0.
 * @param board - game's board
 * @param N - number of digits in one block
 * @param row - pointer to variable holding value of the current row
@@ -152,10 +163,10 @@ int validate_dig (int dig, int row, int col, int m, int n, int N, Num*** board,
 * 1 - if an empty cell has been found
 * 0 - otherwise
 */
-int find_first_empty(Num*** board, int N, int* row, int* col) {
+int find_first_empty(Board* board, int N, int* row, int* col) {
 	for (*row = 0; *row < N; (*row)++) {
 		for (*col = 0; *col < N; (*col)++) {
-			if (board[*row][*col]->alt_num == 0)
+			if (CELL_ALT(board,*row,*col) == 0)
 				return 1;
 		}
 	}
@@ -169,14 +180,14 @@ int find_first_empty(Num*** board, int N, int* row, int* col) {
  * N - number of cells in one row of the board.
  * fill - indicates whether to clear or copy - 0 = clear, 1 = copy num.
  */
-void clear_fill_alt_board (Num*** board, int N, short fill) {
+void clear_fill_alt_board (Board* board, int N, short fill) {
 	int i; int j;
 	for (i = 0; i < N; i++) {
 		for (j = 0; j < N; j++) {
 			if (fill)
-				board[i][j]-> alt_num = board[i][j]->num;
+				CELL_ALT(board,i,j) = CELL_NUM(board,i,j);
 			else
-				board[i][j]-> alt_num = 0;
+				CELL_ALT(board,i,j) = 0;
 		}
 	}
 }
@@ -190,14 +201,14 @@ void clear_fill_alt_board (Num*** board, int N, short fill) {
  * board - game's board
  * count_hid - pointer to counter of hidden cells.
  */
-void pop_till_inc (Stack* stk, int N, Num*** board, int* count_hid) {
+void pop_till_inc (Stack* stk, int N, Board* board, int* count_hid) {
 	int col; int row; int val;
 	/* pop all moves until we can increment the value or reach the end of stack*/
 	while (stk->top != NULL && stk->top->val == N) { /*reset cells*/
 		col = stk->top->col; /*temp*/
 		row = stk->top->row; /*temp*/
 		val = stk->top->val; /*temp*/
-		board[stk->top->row][stk->top->col]-> alt_num = 0;
+		CELL_ALT(board,stk->top->row,stk->top->col) = 0;
 		(*count_hid)++;
 		pop_stack(stk);
 	}
@@ -207,7 +218,7 @@ void pop_till_inc (Stack* stk, int N, Num*** board, int* count_hid) {
 		val = stk->top->val;
 		pop_stack(stk);
 		(*count_hid)++;
-		board[row][col]-> alt_num = 0;
+		CELL_ALT(board,row,col) = 0;
 		push_to_stack(val+1,row,col, stk);
 	}
 }
@@ -223,7 +234,7 @@ void pop_till_inc (Stack* stk, int N, Num*** board, int* count_hid) {
  * number of solutions of the board.
  */
 
-int ex_backtrack (Num*** board, int n, int m, int count_hid) {
+int ex_backtrack (Board* board, int n, int m, int count_hid) {
 	int emp_row; int emp_col; int num_of_sols = 0; int N = n*m;
 	int curr_row; int curr_col; int curr_val; Stack* stk;
 	clear_fill_alt_board(board, n*m, 1);
@@ -236,12 +247,12 @@ int ex_backtrack (Num*** board, int n, int m, int count_hid) {
 			curr_val = stk->top->val;
 			if (validate_dig(curr_val,curr_row,curr_col,m,n,N,board,0,0)) { /*valid value for cell*/
 				count_hid--;
-				board[curr_row][curr_col]->alt_num = curr_val; /*updating board only when value is valid*/
+				CELL_ALT(board,curr_row,curr_col) = curr_val; /*updating board only when value is valid*/
 				if (count_hid == 0) { /*found a solution*/
 					num_of_sols++;
 					pop_stack(stk);
 					count_hid++;
-					board[curr_row][curr_col]-> alt_num = 0;
+					CELL_ALT(board,curr_row,curr_col) = 0;
 					pop_till_inc(stk,N, board, &count_hid); /*backtrack*/
 				}
 				else { /*continue with next empty cell*/
@@ -274,6 +285,8 @@ int ex_backtrack (Num*** board, int n, int m, int count_hid) {
 
 /* ILP*/
 
+#ifndef NO_GUROBI
+
 /**
  * single_val_per_cell - adds the first constraint to the model: Single value per cell.
  * 
@@ -414,31 +427,6 @@ int single_val_per_block(GRBmodel *model, int N, int *error, int  *ind, double *
 	
 }
 
-/**
- * save_results - saves results (received from ILP) to Sudoku board
- * 
- * @param 
- * board - the Sudoku board
- * N - number of cells in one block/row/col
- * y - array with results received from ILP
- *
- */
-void save_results(Num*** board, int N, double *y){
-	int i, j, k;
-	
-	for (i = 0; i < N; i++){
-		for (j = 0; j < N; j++) {
-			for (k = 0; k < N; k++) {
-				if(y[i*N*N + j*N + k]>0.5){
-					board[i][j]->num = k+1;
-					board[i][j]->status = SHOWN;
-				}
-			}
-		}
-	}
-}
-
-
 /**
  * define_model_vars - defines variables for the new model (such as:
  * $lb - array of lower bounds for the new variables.
@@ -448,137 +436,485 @@ void save_results(Num*** board, int N, double *y){
  * board - the Sudoku board
  * N - number of cells in one block/row/col
  * lb - array of lower bounds for the new variables
- * vtype - array of types of the new variables
+ * vtype - array of types of the new variables, or NULL if only the bounds are needed
  *
  */
-void define_model_vars(Num*** board, int N, double *lb, char *vtype){
+void define_model_vars(Board* board, int N, double *lb, char *vtype){
 	int i, j, k;
 	
 	for (i = 0; i < N; i++) {
     for (j = 0; j < N; j++) {
       for (k = 1; k <= N; k++) {
-        if (board[i][j]->num == k)
+        if (CELL_NUM(board,i,j) == k)
           lb[i*N*N+j*N+k-1] = 1;
         else
           lb[i*N*N+j*N+k-1] = 0;
-        vtype[i*N*N+j*N+k-1] = GRB_BINARY;
+        if (vtype)
+          vtype[i*N*N+j*N+k-1] = GRB_BINARY;
       }
     }
   }
 }
 
 /**
- * find_valid_assign - change the "res" variable to the valid number for requested cell
- * 
- * @param 
- * N - number of cells in one block/row/col
- * y - array with results received from ILP
- * h_x - column of required cell (used in hint command)
- * h_y - row of required cell (used in hint command)
- * res - pointer to "res" variable (stores the result)
- *
+ * Type represents the Gurobi state kept between calls to ilp - the environment, which is loaded once per process, and
+ * (with -DILP_FULL_MODEL) the full model of the last board size, whose constraints don't depend on the board's values.
  */
-void find_valid_assign(int N, double *y, int h_x, int h_y, int* res){
-	int k;
-	for (k = 0; k < N; k++) {
-		if(y[h_y*N*N + h_x*N + k]>0.5) {
-			*res = k+1;
-			break;
-		}
-	}
-	
+typedef struct ilp_context {
+	GRBenv* env;
+	GRBmodel* model;
+	int m; int n; /*block size of the model*/
+	double* lb; /*lower bounds of the model's variables*/
+} IlpContext;
+
+IlpContext ilp_ctx = {NULL, NULL, 0, 0, NULL};
+
+/**
+ * free_ilp_model - frees the full model kept in the Gurobi context, and its bounds array.
+ */
+void free_ilp_model() {
+	GRBfreemodel(ilp_ctx.model);
+	free(ilp_ctx.lb);
+	ilp_ctx.model = NULL;
+	ilp_ctx.lb = NULL;
+	ilp_ctx.m = ilp_ctx.n = 0;
 }
 
+/**
+ * free_ilp_context - frees the model and the environment kept in the Gurobi context. called on exit.
+ */
+void free_ilp_context() {
+	free_ilp_model();
+	if (ilp_ctx.env)
+		GRBfreeenv(ilp_ctx.env);
+	ilp_ctx.env = NULL;
+}
 
 /**
- * function solves Sudoku board with ILP. 
- * function defines binary variables: x[i,j,k] - indicate whether cell <i,j> takes value k.  
- * function sets constraints:
- *   1. Single value per cell (sum_k x[i,j,k] = 1)
- *   2. Single value per row (sum_i x[i,j,k] = 1)
- *   3. Single value per column (sum_j x[i,j,k] = 1)
- *   4. Single value per block (sum_ij x[i,j,k] = 1)
- * and solve the Sudoku board using Gurobi Optimizer. Each step's result is saved to "error" variable and 
- * if any error occurs, function frees the memory and returns 0.
- * For hint command, will be returned a valid number for requested cell
- * 
- * @param 
- * board - the Sudoku board
+ * get_ilp_env - loads the Gurobi environment on the first call, and disables its console logging.
+ * @return
+ * 0 - on success
+ * otherwise - the Gurobi error code
+ */
+int get_ilp_env() {
+	int error;
+	if (ilp_ctx.env != NULL)
+		return 0;
+	/* Create environment */
+	error = GRBloadenv(&ilp_ctx.env, "sudoku.log");
+	if (error) {
+		ilp_ctx.env = NULL;
+		return error;
+	}
+	/* Disable console logging */
+	error = GRBsetintparam(ilp_ctx.env, "LogToConsole", 0);
+	if (error) {
+		GRBfreeenv(ilp_ctx.env);
+		ilp_ctx.env = NULL;
+	}
+	return error;
+}
+
+/**
+ * get_ilp_model - returns the full model for boards of the given block size. builds the model - N^3 binary variables
+ * with all four kinds of constraints - whenever the board size changes.
+ * @param
  * m - number of rows in one block
  * n - number of columns in one block
- * calling_func - the name of the function that calls ilp
- * h_x - column of required cell (used in hint command)
- * h_y - row of required cell (used in hint command)
- *
  * @return
- * 0 - an error occurred
- * 1 - no error occurred
- * k - valid number for requested cell (for hint command)
- *
+ * 0 - on success
+ * otherwise - the Gurobi error code
  */
-int ilp(Num*** board, int m, int n, char* calling_func, int h_x, int h_y) {
-  GRBenv   *env   = NULL;
-  GRBmodel *model = NULL;
-	int N = n*m;	int N3 = N*N*N;
-	double *y = malloc(N3*sizeof(double));
-  int *ind = malloc(N*sizeof(int));
-  double *val = malloc(N*sizeof(double));
-  double *lb = malloc(N3*sizeof(double));
-  char *vtype = malloc(N3*sizeof(char));
-	double objval;	int optimstatus;	int error = 0; int res = 1;
-
-  define_model_vars(board, N, lb, vtype);
-
-  /* Create environment */
-  error = GRBloadenv(&env, "sudoku.log");
-  if (error) goto QUIT;
-	/* Disable console logging */
-	error = GRBsetintparam(env, "LogToConsole", 0);
-  if (error) goto QUIT;
-  /* Create new model */
-  error = GRBnewmodel(env, &model, "sudoku", N3, NULL, lb, NULL, vtype, NULL);
-  if (error) goto QUIT;
-	
-	/* Constraints: */
-	error = single_val_per_cell(model, N, &error, ind, val);
+int get_ilp_model(int m, int n) {
+	int N = n*m; int N3 = N*N*N; int error = 0; int k;
+	int* ind; double* val; char* vtype;
+	error = get_ilp_env();
+	if (error)
+		return error;
+	if (ilp_ctx.model != NULL && ilp_ctx.m == m && ilp_ctx.n == n) /*model of this size already built*/
+		return 0;
+	free_ilp_model();
+	ind = malloc(N*sizeof(int));
+	val = malloc(N*sizeof(double));
+	vtype = malloc(N3*sizeof(char));
+	ilp_ctx.lb = calloc(N3,sizeof(double));
+	if (!ind || !val || !vtype || !ilp_ctx.lb) {
+		error = 1;
+		goto QUIT;
+	}
+	for (k = 0; k < N3; k++)
+		vtype[k] = GRB_BINARY;
+	/* Create new model */
+	error = GRBnewmodel(ilp_ctx.env, &ilp_ctx.model, "sudoku", N3, NULL, ilp_ctx.lb, NULL, vtype, NULL);
 	if (error) goto QUIT;
-	error = single_val_per_row(model, N, &error, ind, val);
+	/* Constraints: */
+	error = single_val_per_cell(ilp_ctx.model, N, &error, ind, val);
 	if (error) goto QUIT;
-	error = single_val_per_col(model, N, &error, ind, val);
+	error = single_val_per_row(ilp_ctx.model, N, &error, ind, val);
 	if (error) goto QUIT;
-	error = single_val_per_block(model, N, &error, ind, val, n ,m);
+	error = single_val_per_col(ilp_ctx.model, N, &error, ind, val);
 	if (error) goto QUIT;
-	
-  /* Optimize model */
-  error = GRBoptimize(model);
-  if (error) goto QUIT;
-  /* Capture solution information */
-  error = GRBgetintattr(model, GRB_INT_ATTR_STATUS, &optimstatus);
-  if (error) goto QUIT;
-  error = GRBgetdblattr(model, GRB_DBL_ATTR_OBJVAL, &objval);
-  if (error) goto QUIT;
-	error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, N3, y);
+	error = single_val_per_block(ilp_ctx.model, N, &error, ind, val, n ,m);
 	if (error) goto QUIT;
-	
-	/* Model was solved to optimality and an optimal solution is available */
-  if (optimstatus == GRB_OPTIMAL){
-		if (strcmp(calling_func,"gen") == 0)
-			save_results(board, N, y);
-		else if (strcmp(calling_func,"hint") == 0) {
-			find_valid_assign(N, y, h_x, h_y, &res);
+	ilp_ctx.m = m;
+	ilp_ctx.n = n;
+
+QUIT:
+	if (error)
+		free_ilp_model();
+	free(ind);
+	free(val);
+	free(vtype);
+	return error;
+}
+
+/**
+ * solve_full_model - solves the board with the full model of get_ilp_model: only the lower bounds of the variables
+ * of filled cells are set, and the model is re-optimized.
+ * @param
+ * board - the Sudoku board
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * y - array of N^3 values, receives the values of all the variables
+ * @return
+ * -1 - an error occurred
+ * 0 - the board is unsolvable
+ * 1 - the board was solved, the solution is in y
+ */
+int solve_full_model(Board* board, int m, int n, double* y) {
+	int N = n*m; int N3 = N*N*N; int optimstatus; int error;
+	error = get_ilp_model(m, n);
+	if (error) return -1;
+	/* Fix the values of filled cells */
+	define_model_vars(board, N, ilp_ctx.lb, NULL);
+	error = GRBsetdblattrarray(ilp_ctx.model, GRB_DBL_ATTR_LB, 0, N3, ilp_ctx.lb);
+	if (error) return -1;
+	/* Optimize model */
+	error = GRBoptimize(ilp_ctx.model);
+	if (error) return -1;
+	/* Capture solution information */
+	error = GRBgetintattr(ilp_ctx.model, GRB_INT_ATTR_STATUS, &optimstatus);
+	if (error) return -1;
+	if (optimstatus != GRB_OPTIMAL)
+		return 0;
+	error = GRBgetdblattrarray(ilp_ctx.model, GRB_DBL_ATTR_X, 0, N3, y);
+	return error ? -1 : 1;
+}
+
+/**
+ * presolve_model - finds the variables of the reduced model: a filled cell has none, and an empty cell has one
+ * variable for each of its candidates (digits not used by its row, column and block peers).
+ * @param
+ * board - the Sudoku board
+ * var_of - array of N^3 entries, receives the reduced variable of x[i,j,k], or -1 if there is none
+ * var_full - array of N^3 entries, receives the index in the full model (i*N*N+j*N+k-1) of each reduced variable
+ * cand - array of board->words words, used for the candidates of a cell
+ * @return
+ * -1 - the board is unsolvable: some unit has a digit twice, or an empty cell has no candidates
+ * k - number of variables in the reduced model
+ */
+int presolve_model(Board* board, int* var_of, int* var_full, unsigned long* cand) {
+	int N = board->N; int units = 3*N; int nvars = 0;
+	int unit, dig, idx, k;
+	for (unit = 0; unit < units; unit++)
+		for (dig = 1; dig <= N; dig++)
+			if (UNIT_CNT(board,unit,dig) > 1)
+				return -1;
+	for (idx = 0; idx < N*N; idx++) {
+		for (k = 0; k < N; k++)
+			var_of[idx*N+k] = -1;
+		if (NUM_AT(board,idx))
+			continue;
+		if (!cell_candidates(board, IDX_ROW(board,idx), IDX_COL(board,idx), cand))
+			return -1;
+		for (dig = next_dig(cand, board->words, 1); dig; dig = next_dig(cand, board->words, dig+1)) {
+			var_of[idx*N+dig-1] = nvars;
+			var_full[nvars++] = idx*N+dig-1;
 		}
-  }
+	}
+	return nvars;
+}
+
+/**
+ * add_reduced_constrs - adds the constraints of the reduced model: single value per empty cell, and, for each digit
+ * missing from a row, column or block, a single position for it among the unit's empty cells.
+ * constraints which are already satisfied by the filled cells are left out.
+ * @param
+ * model - the reduced model
+ * board - the Sudoku board
+ * var_of - reduced variable of each x[i,j,k], or -1 (see presolve_model)
+ * ind - array of N indices
+ * val - array of N coefficients
+ * @return
+ * -1 - the board is unsolvable: some digit has no position in a unit which misses it
+ * 0 - on success
+ * otherwise - the Gurobi error code
+ */
+int add_reduced_constrs(GRBmodel* model, Board* board, int* var_of, int* ind, double* val) {
+	int N = board->N; int error; int nz; int idx, unit, dig, pos, k;
+	for (idx = 0; idx < N*N; idx++) {
+		if (NUM_AT(board,idx))
+			continue;
+		nz = 0;
+		for (k = 0; k < N; k++)
+			if (var_of[idx*N+k] >= 0) {
+				ind[nz] = var_of[idx*N+k];
+				val[nz++] = 1.0;
+			}
+		error = GRBaddconstr(model, nz, ind, val, GRB_EQUAL, 1.0, NULL);
+		if (error) return error;
+	}
+	for (unit = 0; unit < 3*N; unit++) {
+		for (dig = 1; dig <= N; dig++) {
+			if (UNIT_CNT(board,unit,dig)) /*digit already placed in this unit*/
+				continue;
+			nz = 0;
+			for (pos = 0; pos < N; pos++) {
+				idx = unit_cell(board, unit, pos);
+				if (var_of[idx*N+dig-1] >= 0) {
+					ind[nz] = var_of[idx*N+dig-1];
+					val[nz++] = 1.0;
+				}
+			}
+			if (nz == 0)
+				return -1;
+			error = GRBaddconstr(model, nz, ind, val, GRB_EQUAL, 1.0, NULL);
+			if (error) return error;
+		}
+	}
+	return 0;
+}
+
+/**
+ * solve_reduced_model - solves the board with a model built for its current state: filled cells and digits excluded
+ * by their peers get no variables (see presolve_model), and satisfied constraints are left out
+ * (see add_reduced_constrs). the values of the reduced variables are mapped back to the full N^3 variables, so the
+ * results can be read by ilp_grid.
+ * @param
+ * board - the Sudoku board
+ * y - array of N^3 values, receives the values of all the variables
+ * @return
+ * -1 - an error occurred
+ * 0 - the board is unsolvable
+ * 1 - the board was solved, the solution is in y
+ */
+int solve_reduced_model(Board* board, double* y) {
+	int N = board->N; int N3 = N*N*N; int res = -1; int error; int nvars; int optimstatus; int v;
+	GRBmodel* model = NULL;
+	int* var_of = malloc(N3*sizeof(int));
+	int* var_full = malloc(N3*sizeof(int));
+	unsigned long* cand = malloc(board->words*sizeof(unsigned long));
+	int* ind = malloc(N*sizeof(int));
+	double* val = malloc(N*sizeof(double));
+	double* x = NULL;
+	char* vtype = NULL;
+	if (!var_of || !var_full || !cand || !ind || !val)
+		goto QUIT;
+	nvars = presolve_model(board, var_of, var_full, cand);
+	if (nvars == -1) {
+		res = 0;
+		goto QUIT;
+	}
+	define_model_vars(board, N, y, NULL); /*values of the filled cells*/
+	if (nvars == 0) { /*nothing left to solve*/
+		res = 1;
+		goto QUIT;
+	}
+	x = malloc(nvars*sizeof(double));
+	vtype = malloc(nvars*sizeof(char));
+	if (!x || !vtype || get_ilp_env())
+		goto QUIT;
+	for (v = 0; v < nvars; v++)
+		vtype[v] = GRB_BINARY;
+	/* Create new model */
+	error = GRBnewmodel(ilp_ctx.env, &model, "sudoku", nvars, NULL, NULL, NULL, vtype, NULL);
+	if (error) goto QUIT;
+	/* Constraints: */
+	error = add_reduced_constrs(model, board, var_of, ind, val);
+	if (error) {
+		res = error == -1 ? 0 : -1;
+		goto QUIT;
+	}
+	/* Optimize model */
+	error = GRBoptimize(model);
+	if (error) goto QUIT;
+	/* Capture solution information */
+	error = GRBgetintattr(model, GRB_INT_ATTR_STATUS, &optimstatus);
+	if (error) goto QUIT;
+	if (optimstatus != GRB_OPTIMAL) {
+		res = 0;
+		goto QUIT;
+	}
+	error = GRBgetdblattrarray(model, GRB_DBL_ATTR_X, 0, nvars, x);
+	if (error) goto QUIT;
+	for (v = 0; v < nvars; v++)
+		y[var_full[v]] = x[v];
+	res = 1;
 
 QUIT:
- /* Free model, environment, memory */
-  GRBfreemodel(model);
-  GRBfreeenv(env);
-	free(y);
+	GRBfreemodel(model);
+	free(var_of);
+	free(var_full);
+	free(cand);
 	free(ind);
 	free(val);
-	free(lb);
+	free(x);
 	free(vtype);
-	
-	return error ? 0 : res;
+	return res;
 }
 
+/**
+ * ilp_grid - solves the board with ILP, and returns the value of every cell of the solution.
+ * function defines binary variables: x[i,j,k] - indicate whether cell <i,j> takes value k.
+ * function sets constraints:
+ *   1. Single value per cell (sum_k x[i,j,k] = 1)
+ *   2. Single value per row (sum_i x[i,j,k] = 1)
+ *   3. Single value per column (sum_j x[i,j,k] = 1)
+ *   4. Single value per block (sum_ij x[i,j,k] = 1)
+ * and solve the Sudoku board using Gurobi Optimizer.
+ * By default only the variables and constraints that the filled cells leave open are passed to Gurobi
+ * (see solve_reduced_model). When compiled with -DILP_FULL_MODEL, the full N^3 model is kept between calls and
+ * only its lower bounds are updated (see solve_full_model).
+ * @param
+ * board - the Sudoku board
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * grid - array of N*N values, receives the solution in row-major order
+ * @return
+ * -1 - an error occurred
+ * 0 - the board is unsolvable
+ * 1 - the board was solved
+ */
+int ilp_grid(Board* board, int m, int n, int* grid) {
+	int N = n*m; int solved; int idx; int k;
+	double* y = malloc(N*N*N*sizeof(double));
+	if (!y)
+		return -1;
+#ifdef ILP_FULL_MODEL
+	solved = solve_full_model(board, m, n, y);
+#else
+	solved = solve_reduced_model(board, y);
+#endif
+	if (solved == 1)
+		for (idx = 0; idx < N*N; idx++)
+			for (k = 0; k < N; k++)
+				if (y[idx*N+k] > 0.5)
+					grid[idx] = k+1;
+	free(y);
+	return solved;
+}
+
+#endif /*NO_GUROBI*/
+
+
+/*SOLVER ENGINES*/
+
+#ifdef NO_GUROBI
+ENGINE solver_engine = NATIVE_ENGINE;
+#else
+ENGINE solver_engine = GUROBI_ENGINE;
+#endif
+
+/**
+ * set_solver_engine - selects the engine used by solution_grid.
+ * @param
+ * name - "native" for the built-in solver, "gurobi" for ILP with Gurobi
+ * @return
+ * 1 - if the engine was selected
+ * 0 - if there is no such engine in this build
+ */
+int set_solver_engine(char* name) {
+	if (!strcmp(name,"native"))
+		solver_engine = NATIVE_ENGINE;
+#ifndef NO_GUROBI
+	else if (!strcmp(name,"gurobi"))
+		solver_engine = GUROBI_ENGINE;
+#endif
+	else
+		return 0;
+	return 1;
+}
+
+/**
+ * get_solver_engine - returns the engine selected with set_solver_engine.
+ * @return
+ * NATIVE_ENGINE or GUROBI_ENGINE
+ */
+ENGINE get_solver_engine() {
+	return solver_engine;
+}
+
+/**
+ * solution_grid - returns a solution of the board. the solution is cached in the board, and the selected engine is
+ * called only when the cache can't answer:
+ *   1. the board's hash equals the hash it had when the cached result was found - the board wasn't changed (or was
+ *      changed back), so the cached result holds, even if it was that the board is unsolvable.
+ *   2. every filled cell agrees with the cached solution (board->sol_diff == 0, kept by set_cell_num) - the cells
+ *      filled or emptied since then only moved along the solution, so it is still a solution of the board.
+ * @param
+ * board - the Sudoku board
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * @return
+ * NULL - the board is unsolvable or an error occurred
+ * otherwise - array of N*N values, the solution in row-major order. owned by the board, valid until the next call.
+ */
+int* solution_grid(Board* board, int m, int n) {
+	int N = n*m; int res;
+	if (board->sol_state != 0 && board->sol_hash == board->hash)
+		return board->sol_state == 1 ? board->sol : NULL;
+	if (board->sol_state == 1 && board->sol_diff == 0) {
+		board->sol_hash = board->hash;
+		return board->sol;
+	}
+	board->sol_state = 0; /*invalid until solved*/
+	if (!board->sol) {
+		board->sol = malloc(N*N*sizeof(int));
+		if (!board->sol)
+			return NULL;
+	}
+#ifndef NO_GUROBI
+	if (solver_engine == GUROBI_ENGINE)
+		res = ilp_grid(board, m, n, board->sol);
+	else
+#endif
+		res = native_solve(board, board->sol, NULL);
+	if (res == -1) /*errors are not cached*/
+		return NULL;
+	board->sol_state = res ? 1 : -1;
+	board->sol_hash = board->hash;
+	board->sol_diff = 0; /*a solution agrees with all filled cells*/
+	return res ? board->sol : NULL;
+}
+
+/**
+ * hint_cells - returns the values of the given cells in a solution of the board (see solution_grid).
+ * @param
+ * board - the Sudoku board
+ * m - number of rows in one block
+ * n - number of columns in one block
+ * cells - indices of the requested cells (row*N+col), or NULL for all the cells of the board
+ * count - number of requested cells
+ * digs - array of count values, receives the value of each requested cell
+ * @return
+ * 0 - the board is unsolvable or an error occurred
+ * 1 - on success
+ */
+int hint_cells(Board* board, int m, int n, int* cells, int count, int* digs) {
+	int i;
+	int* grid = solution_grid(board, m, n);
+	if (!grid)
+		return 0;
+	for (i = 0; i < count; i++)
+		digs[i] = grid[cells ? cells[i] : i];
+	return 1;
+}
+
+/**
+ * free_solver - frees the resources kept by the solver engines between calls.
+ */
+void free_solver() {
+#ifndef NO_GUROBI
+	free_ilp_context();
+#endif
+}
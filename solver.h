@@ -9,19 +9,37 @@
 * validate_col - checks if a placement of a given digit in a given cell is valid, according to its column.
 * validate_block - checks if a placement of a given digit in a given cell is valid, according to its block.
 * ex_backtrack - executes exhaustive backtrack to find number of solutions of the board using a stack.
-* ilp - function solves Sudoku board with ILP using Gurobi.
+* ilp_grid - solves Sudoku board with ILP using Gurobi, and returns the whole solution (not available when compiled
+*            with -DNO_GUROBI).
+* set_solver_engine - selects the engine used by solution_grid - ILP with Gurobi, or the built-in solver.
+* get_solver_engine - returns the selected engine.
+* solution_grid - returns a solution of the board, reusing the one cached in the board while it still holds.
+* hint_cells - returns the values of the given cells (or of all the cells) in a solution of the board.
+* free_solver - frees the resources kept by the solver engines between calls (the Gurobi environment and model).
 *
 */
 
 
-extern int validate_dig (int dig, int row, int col, int m, int n, int N, Num*** board, int change_err, int num_alt);
+extern int validate_dig (int dig, int row, int col, int m, int n, int N, Board* board, int change_err, int num_alt);
 
-extern int validate_row(int dig, int row, int N, Num*** board, int change_err, int num_alt);
+extern int validate_row(int dig, int row, int N, Board* board, int change_err, int num_alt);
 
-extern int validate_col(int dig, int col, int N, Num*** board, int change_err, int num_alt);
+extern int validate_col(int dig, int col, int N, Board* board, int change_err, int num_alt);
 
-extern int validate_block(int dig, int row, int col, int m, int n, Num*** board, int change_err, int num_alt);
+extern int validate_block(int dig, int row, int col, int m, int n, Board* board, int change_err, int num_alt);
 
-extern int ex_backtrack (Num*** board, int m, int n, int count_hid);
+extern int ex_backtrack (Board* board, int m, int n, int count_hid);
 
-extern int ilp(Num*** board, int m, int n, char* calling_func, int h_x, int h_y);
+#ifndef NO_GUROBI
+extern int ilp_grid(Board* board, int m, int n, int* grid);
+#endif
+
+extern int set_solver_engine(char* name);
+
+extern ENGINE get_solver_engine();
+
+extern int* solution_grid(Board* board, int m, int n);
+
+extern int hint_cells(Board* board, int m, int n, int* cells, int count, int* digs);
+
+extern void free_solver();
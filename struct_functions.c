@@ -1,153 +1,237 @@
 #include <stdlib.h>
+#include <string.h>
 #include "structs.h"
 
 /**
- * create_num initializes struct Num, which represents a cell, by saving the given number, and calls
- * create_arr function to initialize the array of valid numbers for this cell.
- *
- * @param
- * input_num - the number to put in cell
- * N - represents the number of cells in row/col and the max valid number for Sudoku puzzle
- *
- * @return
- * pointer to struct Num which represents a cell
- *
+ * the undo/redo move log is kept in move_pool, a list of chunks from which its nodes are allocated one after the
+ * other: a MoveList node is followed by the array of its steps, then by its checkpoint if it has one, and then by
+ * the next MoveList node. the order of the nodes in the pool is therefore the order of the list, so truncating the
+ * list after some node releases the rest of the pool at once, and the chunks are reused by the following moves
+ * instead of being freed.
+ * none of the functions that release the log walk its nodes, so clearing a history of any length (a long session, or
+ * a generate of a large board in one move) takes constant stack space.
+ * the checkpoint of the empty node is the board before the first move, it is allocated after the first move.
  */
-Num* create_num(int input_num) { 
-	Num* new_num = (Num*) malloc(sizeof(Num));
-	if (!new_num) {
-		return NULL;
-	}
-	new_num -> num = input_num;
-	new_num -> alt_num = 0;
-	new_num -> status = HIDDEN;
-	return new_num;
-}
+MovePool move_pool = {NULL, NULL};
 
 /**
- * destroy_num - releases a memory used to initialize the struct Num
- *
- * @param n - pointer to struct Num, which represents the number that appears in the cell.
- *
+ * Type used to round the sizes of pool allocations, so that every node in a chunk is aligned.
  */
-void destroy_num (Num* n) {
-	if (!n) {
-		return;
-	}
-	free(n);
-	return;
-}
+typedef union pool_align {
+	void* p;
+	long l;
+	double d;
+} PoolAlign;
+
+#define POOL_ROUND(size) (((size) + sizeof(PoolAlign) - 1) / sizeof(PoolAlign) * sizeof(PoolAlign))
+#define CHUNK_DATA(chunk) ((char*) (chunk) + POOL_ROUND(sizeof(PoolChunk)))
+#define MIN_CHUNK 4096
 
-/** create_single_set - creats a SingleSet structure which represents one change of cell on board.
+/**
+ * pool_alloc - allocates size bytes at the end of the move pool. moves to the next chunk when the current one is
+ * full, and allocates a new chunk (twice as large as the last one) only when there is no next chunk to reuse.
  * @param
- * prev_val - previous value of the cell
- * new_val - new value of the cell
- * col - column in which the cell is located
- * row - row in which the cell is located.
+ * size - number of bytes to allocate
  * @return
- * pointer to SingleSet created.
+ * pointer to the allocated bytes, NULL if allocation failed
  */
-SingleSet* create_single_set(int prev_val, int new_val, int col, int row) {
-	SingleSet* new_set = (SingleSet*) malloc(sizeof(SingleSet));
-	if (!new_set) {
-		return NULL;
+void* pool_alloc(size_t size) {
+	PoolChunk* cur = move_pool.cur; PoolChunk* chunk; size_t cap;
+	void* res;
+	size = POOL_ROUND(size);
+	if (cur == NULL || cur->used + size > cur->cap) {
+		if (cur != NULL && cur->next != NULL && cur->next->cap >= size)
+			chunk = cur->next;
+		else {
+			cap = cur == NULL ? MIN_CHUNK : 2*cur->cap;
+			if (cap < size)
+				cap = size;
+			chunk = malloc(POOL_ROUND(sizeof(PoolChunk)) + cap);
+			if (!chunk)
+				return NULL;
+			chunk->cap = cap;
+			if (cur == NULL) {
+				chunk->next = move_pool.first;
+				move_pool.first = chunk;
+			}
+			else {
+				chunk->next = cur->next;
+				cur->next = chunk;
+			}
+		}
+		chunk->used = 0;
+		move_pool.cur = cur = chunk;
 	}
-	new_set->prev_val = prev_val;
-	new_set->new_val = new_val;
-	new_set->col = col;
-	new_set->row = row;
-	return new_set;
+	res = CHUNK_DATA(cur) + cur->used;
+	cur->used += size;
+	return res;
 }
 
 /**
- * create_move - creates a move with one cell change of the board.
+ * pool_release - releases a node of the move pool, and all the nodes allocated after it.
  * @param
- * cell_set - SingleSet of the change of the board.
- * @return
- * pointer to new move
+ * node - a node allocated from the pool
  */
-Move* create_move(SingleSet* cell_set) {
-	Move* head = (Move*) malloc(sizeof(Move));
-	head->change = cell_set;
-	head->next=NULL;
-	return head;
+void pool_release(void* node) {
+	PoolChunk* chunk = move_pool.first;
+	while (chunk != NULL && !((char*) node >= CHUNK_DATA(chunk) && (char*) node < CHUNK_DATA(chunk) + chunk->used))
+		chunk = chunk->next;
+	if (chunk == NULL) /*not in use*/
+		return;
+	chunk->used = (char*) node - CHUNK_DATA(chunk);
+	move_pool.cur = chunk;
 }
 
 /**
- * delete_move - frees the list of Moves.
- * @param
- * head - the move to free.
+ * free_move_pool - frees all the chunks of the move pool, including the empty node of the move list.
+ * the chunks are freed in a loop, their number is logarithmic in the largest size the log reached.
  */
-void delete_move (Move* head) {
-	if (head != NULL){
-		free(head->change);
-		delete_move (head->next);
-		free(head);
+void free_move_pool() {
+	PoolChunk* chunk = move_pool.first; PoolChunk* next;
+	while (chunk != NULL) {
+		next = chunk->next;
+		free(chunk);
+		chunk = next;
 	}
+	move_pool.first = move_pool.cur = NULL;
 }
 
 /**
- * create_move_list - creates a MoveList node, with a given previous Movelist node and a pointer to the first Move on the list of Moves in this node.
+ * first_move - finds the empty node of the move list, which is the first node in the move pool.
+ * @return
+ * pointer to the empty node
+ */
+MoveList* first_move() {
+	return (MoveList*) CHUNK_DATA(move_pool.first);
+}
+
+/**
+ * create_move_list - creates a MoveList node, with a given previous Movelist node and room for the given number of steps.
+ * the node is allocated at the end of the move pool, so everything allocated after tail must be released before
+ * (see empty_move_list_forward).
  * @param
  * tail - the previous MoveList, which is the previous tail of the list
- * head_move - first Move of the list of moves to be contained in this node.
+ * steps - number of cell changes of the move, 0 for the empty node
+ * @return
+ * pointer to the new node, NULL if allocation failed
  */
-MoveList* create_move_list (MoveList* tail, Move* head_move) {
-	MoveList* new_move = (MoveList*) malloc(sizeof(MoveList));
+MoveList* create_move_list (MoveList* tail, int steps) {
+	MoveList* new_move = (MoveList*) pool_alloc(sizeof(MoveList));
+	if (!new_move)
+		return NULL;
+	new_move->steps = NULL;
+	if (steps > 0 && !(new_move->steps = (SingleSet*) pool_alloc(steps*sizeof(SingleSet)))) {
+		pool_release(new_move);
+		return NULL;
+	}
+	new_move->step_cnt = 0;
+	new_move->since_ckpt = 0;
+	new_move->snapshot = NULL;
 	new_move->prev = tail;
-	new_move->head_move = head_move;
 	new_move->next = NULL;
 	return new_move;
 }
 
 /**
  * empty_move_list_forward - frees all forward MoveList nodes including the given one.
+ * the given node and its forward nodes are the last ones in the move pool, so they are released at once.
  * @param
  * curr_move - pointer to current node in the MoveList list.
  */
 void empty_move_list_forward (MoveList* curr_move) {
-	if (curr_move != NULL){
-		delete_move(curr_move->head_move);
-		empty_move_list_forward(curr_move->next);
-		free(curr_move);
+	if (curr_move != NULL) {
+		if (curr_move->prev != NULL) {
+			curr_move->prev->next = NULL;
+			if (curr_move->prev->prev == NULL) /*the checkpoint of the empty node was allocated after this node*/
+				curr_move->prev->snapshot = NULL;
+		}
+		pool_release(curr_move);
 	}
 }
 
 /**
- * empty_move_list_backward - frees all backward MoveList nodes including the given one, except for the empty node.
+ * new_move - clears the moves beyond the current move, and adds an empty move after it.
  * @param
- * curr_move - pointer to current node in the MoveList list.
+ * curr_move - the current node in the MoveList list.
+ * steps - number of cell changes the move will have
  * @return
- * pointer to the empty node
+ * pointer to the new node, NULL if allocation failed
+ */
+MoveList* new_move (MoveList* curr_move, int steps) {
+	empty_move_list_forward(curr_move->next);
+	curr_move->next = create_move_list(curr_move, steps);
+	return curr_move->next;
+}
+
+/**
+ * add_step - adds one cell change to a move, in the next free entry of its steps array.
+ * @param
+ * move - the move, created with room for this step
+ * prev_val - previous value of the cell
+ * new_val - new value of the cell
+ * col - column in which the cell is located
+ * row - row in which the cell is located.
+ */
+void add_step (MoveList* move, int prev_val, int new_val, int col, int row) {
+	SingleSet* step = &move->steps[move->step_cnt++];
+	step->prev_val = prev_val;
+	step->new_val = new_val;
+	step->col = col;
+	step->row = row;
+}
+
+/**
+ * take_snapshot - allocates a checkpoint from the move pool and copies the cells' values of the board to it.
+ * @param
+ * board - game's board
+ * @return
+ * the checkpoint, NULL if allocation failed
  */
-MoveList* empty_move_list_backward (MoveList* curr_move) {
-	MoveList * empty_node;
-	if (curr_move->head_move == NULL)
-		return curr_move;
-	delete_move(curr_move->head_move);
-	empty_node = empty_move_list_backward(curr_move->prev);
-	free(curr_move);
-	return empty_node;
+int* take_snapshot(Board* board) {
+	int idx; int* snapshot = (int*) pool_alloc(board->N*board->N*sizeof(int));
+	if (snapshot != NULL) {
+		for (idx = 0; idx < board->N*board->N; idx++)
+			snapshot[idx] = NUM_AT(board,idx);
+	}
+	return snapshot;
+}
+
+/**
+ * end_move - completes a move after all its steps were added and made on the board.
+ * the first move after the empty node gives the empty node its checkpoint (the board with the move's steps undone),
+ * and a move gets a checkpoint of its own once N*N cell changes were made since the last one, so the checkpoints
+ * take at most a quarter of the memory of the steps.
+ * @param
+ * move - the move, must be the last node of the list
+ * board - game's board, after the move
+ */
+void end_move (MoveList* move, Board* board) {
+	MoveList* prev = move->prev; int i; SingleSet* step;
+	if (prev->prev == NULL && prev->snapshot == NULL && (prev->snapshot = take_snapshot(board)) != NULL) {
+		for (i = move->step_cnt-1; i >= 0; i--) {
+			step = &move->steps[i];
+			prev->snapshot[CELL_IDX(board,step->row,step->col)] = step->prev_val;
+		}
+		prev->since_ckpt = 0;
+	}
+	move->since_ckpt = prev->since_ckpt + move->step_cnt;
+	if (move->since_ckpt >= board->N*board->N && (move->snapshot = take_snapshot(board)) != NULL)
+		move->since_ckpt = 0;
 }
 
 /**
  * empty move list - frees all nodes of the move list except for the empty node and changes the pointer to it.
  * the function sets the curr_move pointer to the empty node.
+ * the empty node is the first node in the move pool, so the whole pool after it is released in one reset.
  * @param
  * curr_move - pointer to the current node on the move list.
  */
 void empty_move_list(MoveList** curr_move) {
-	MoveList* empty_node;
-	if ((*curr_move)->head_move != NULL) {
-		delete_move((*curr_move)->head_move);
-		empty_move_list_forward((*curr_move)->next);
-		empty_node = empty_move_list_backward((*curr_move)->prev);
-		free (*curr_move);
-		*curr_move = empty_node;
-	}
-	else
-		empty_move_list_forward((*curr_move)->next);
+	*curr_move = first_move();
+	move_pool.first->used = POOL_ROUND(sizeof(MoveList));
+	move_pool.cur = move_pool.first;
 	(*curr_move)->next = NULL;
+	(*curr_move)->snapshot = NULL;
 }
 
 /**
@@ -187,3 +271,409 @@ void pop_stack (Stack *stk) {
 	stk->top = stk->top->next;
 	free(p);
 }
+
+/**
+ * update_unit - adds (delta = 1) or removes (delta = -1) one occurrence of dig, in cell idx, from the given unit of
+ * the constraint index.
+ * the digit's bit in the unit's bitset is kept set as long as the digit occurs in the unit at least once, and the board's
+ * count of repeated digits changes when the digit starts or stops occurring in the unit more than once.
+ * @param
+ * board - game's board
+ * unit - index of the unit (row, column or block)
+ * dig - the digit
+ * idx - index of the cell
+ * delta - 1 or -1
+ */
+void update_unit(Board* board, int unit, int dig, int idx, int delta) {
+	int* cnt = &UNIT_CNT(board,unit,dig);
+	*cnt += delta;
+	UNIT_SUM(board,unit,dig) += delta*idx;
+	if (*cnt == 2 && delta > 0) /*dig is now repeated in unit*/
+		board->dup_cnt++;
+	else if (*cnt == 1 && delta < 0)
+		board->dup_cnt--;
+	if (*cnt == 0)
+		UNIT_BITS(board,unit)[DIG_WORD(dig)] &= ~DIG_MASK(dig);
+	else if (*cnt == 1 && delta > 0)
+		UNIT_BITS(board,unit)[DIG_WORD(dig)] |= DIG_MASK(dig);
+}
+
+/**
+ * cell_conflicts - checks whether the digit of a filled cell appears again in its row, column or block.
+ * @param
+ * board - game's board
+ * idx - index of the cell
+ * @return
+ * non zero - if the cell's digit appears in one of its units more than once
+ * 0 - otherwise
+ */
+int cell_conflicts(Board* board, int idx) {
+	int row = IDX_ROW(board,idx); int col = IDX_COL(board,idx); int dig = NUM_AT(board,idx);
+	return UNIT_CNT(board,ROW_UNIT(board,row),dig) > 1 || UNIT_CNT(board,COL_UNIT(board,col),dig) > 1
+			|| UNIT_CNT(board,BLOCK_UNIT(board,row,col),dig) > 1;
+}
+
+/**
+ * refresh_status - marks a filled cell that isn't fixed as ERRONEOUS if its digit appears again in one of its units,
+ * and as SHOWN otherwise, and updates the board's count of erroneous cells.
+ * @param
+ * board - game's board
+ * idx - index of the cell
+ */
+void refresh_status(Board* board, int idx) {
+	int err;
+	if (NUM_AT(board,idx) == 0 || STAT_AT(board,idx) == FIXED)
+		return;
+	err = cell_conflicts(board,idx);
+	if (err && STAT_AT(board,idx) != ERRONEOUS)
+		board->err_cnt++;
+	else if (!err && STAT_AT(board,idx) == ERRONEOUS)
+		board->err_cnt--;
+	STAT_AT(board,idx) = err ? ERRONEOUS : SHOWN;
+}
+
+/**
+ * zobrist_key - gives the Zobrist key of a digit in a cell, from which the board's hash is computed. the key is a hash
+ * of the cell and the digit (a 32 bit integer mixer, applied once for every 32 bits of unsigned long), so no table of
+ * keys is kept, and the keys are the same for every board, every thread and every run.
+ * @param
+ * idx - index of the cell
+ * dig - the digit, 1..N
+ * @return
+ * the key
+ */
+unsigned long zobrist_key(int idx, int dig) {
+	unsigned long key = 0; unsigned long x; unsigned int b;
+	for (b = 0; b < CHAR_BIT*sizeof(unsigned long); b += 32) {
+		x = ((unsigned long) idx*0x9E3779B1UL + (unsigned long) dig*0x85EBCA77UL + b) & 0xFFFFFFFFUL;
+		x ^= x >> 16;
+		x = (x*0x7FEB352DUL) & 0xFFFFFFFFUL;
+		x ^= x >> 15;
+		x = (x*0x846CA68BUL) & 0xFFFFFFFFUL;
+		x ^= x >> 16;
+		key = (key << 16 << 16) ^ x; /*two shifts, as unsigned long may have only 32 bits*/
+	}
+	return key;
+}
+
+/**
+ * set_cell_num - puts dig in cell <row,col> and updates the row, column and block of the cell in the constraint index.
+ * every change of a cell's num value should go through this function, so that the index stays in sync with the board.
+ * the function also keeps the cells' statuses: an emptied cell becomes HIDDEN, a filled cell that isn't fixed becomes
+ * ERRONEOUS or SHOWN, and so does the peer that shared the old digit in a unit (found by UNIT_SUM once it is alone)
+ * or that now shares the new one, and counts the filled cells (see board_solved). this takes O(1), instead of
+ * rescanning the cell's row, column and block.
+ * @param
+ * board - game's board
+ * row - row in which the cell is located
+ * col - column in which the cell is located
+ * dig - the new value of the cell, 0 to empty it.
+ */
+void set_cell_num(Board* board, int row, int col, int dig) {
+	int prev = CELL_NUM(board,row,col); int idx = CELL_IDX(board,row,col);
+	int units[3]; int u;
+	if (prev == dig)
+		return;
+	units[0] = ROW_UNIT(board,row);
+	units[1] = COL_UNIT(board,col);
+	units[2] = BLOCK_UNIT(board,row,col);
+	CELL_NUM(board,row,col) = dig;
+	if (prev != 0) {
+		for (u = 0; u < 3; u++)
+			update_unit(board,units[u],prev,idx,-1);
+		board->hash ^= zobrist_key(idx,prev);
+		if (board->sol_state == 1 && prev != board->sol[idx])
+			board->sol_diff--;
+		board->filled_cnt--;
+	}
+	if (dig != 0) {
+		for (u = 0; u < 3; u++)
+			update_unit(board,units[u],dig,idx,1);
+		board->hash ^= zobrist_key(idx,dig);
+		if (board->sol_state == 1 && dig != board->sol[idx])
+			board->sol_diff++;
+		board->filled_cnt++;
+	}
+	/*update statuses*/
+	if (dig == 0) {
+		if (CELL_STAT(board,row,col) == ERRONEOUS)
+			board->err_cnt--;
+		CELL_STAT(board,row,col) = HIDDEN;
+	}
+	else
+		refresh_status(board,idx);
+	for (u = 0; u < 3; u++) {
+		if (prev != 0 && UNIT_CNT(board,units[u],prev) == 1) /*the peer left with prev*/
+			refresh_status(board,UNIT_SUM(board,units[u],prev));
+		if (dig != 0 && UNIT_CNT(board,units[u],dig) == 2) /*the peer that had dig alone*/
+			refresh_status(board,UNIT_SUM(board,units[u],dig)-idx);
+	}
+}
+
+/**
+ * build_board_index - rebuilds the constraint index and the hash of the board from scratch, according to the cells'
+ * num values, marks the filled cells that aren't fixed as ERRONEOUS or SHOWN and the empty cells as HIDDEN.
+ * the cached solution is kept, and the number of cells that differ from it is recounted.
+ * @param
+ * board - game's board
+ */
+void build_board_index(Board* board) {
+	int N = board->N; int row; int col; int dig; int idx;
+	memset(board->unit_cnt, 0, 3*N*(N+1)*sizeof(int));
+	memset(board->unit_sum, 0, 3*N*(N+1)*sizeof(int));
+	memset(board->unit_used, 0, 3*N*board->words*sizeof(unsigned long));
+	board->hash = 0;
+	board->sol_diff = 0;
+	board->filled_cnt = board->dup_cnt = 0;
+	for (row = 0; row < N; row++) {
+		for (col = 0; col < N; col++) {
+			dig = CELL_NUM(board,row,col);
+			idx = CELL_IDX(board,row,col);
+			if (dig != 0) {
+				update_unit(board,ROW_UNIT(board,row),dig,idx,1);
+				update_unit(board,COL_UNIT(board,col),dig,idx,1);
+				update_unit(board,BLOCK_UNIT(board,row,col),dig,idx,1);
+				board->hash ^= zobrist_key(idx,dig);
+				if (board->sol_state == 1 && dig != board->sol[idx])
+					board->sol_diff++;
+				board->filled_cnt++;
+			}
+		}
+	}
+	board->err_cnt = 0;
+	for (idx = 0; idx < N*N; idx++) {
+		if (NUM_AT(board,idx) == 0)
+			STAT_AT(board,idx) = HIDDEN;
+		else if (STAT_AT(board,idx) != FIXED) {
+			STAT_AT(board,idx) = cell_conflicts(board,idx) ? ERRONEOUS : SHOWN;
+			if (STAT_AT(board,idx) == ERRONEOUS)
+				board->err_cnt++;
+		}
+	}
+}
+
+/**
+ * apply_steps - puts the values of the steps of a move in the board's cells, without updating the index.
+ * @param
+ * board - game's board
+ * move - the move
+ * back - 1 to put the steps' previous values, undoing the move, 0 to put their new values
+ */
+void apply_steps(Board* board, MoveList* move, int back) {
+	int i; SingleSet* step;
+	for (i = 0; i < move->step_cnt; i++) {
+		step = &move->steps[back ? move->step_cnt-1-i : i];
+		CELL_NUM(board,step->row,step->col) = back ? step->prev_val : step->new_val;
+	}
+}
+
+/**
+ * goto_move - brings the board from its state after move curr to its state after move target, which is before curr
+ * on the move list (undo) or after it (redo).
+ * when the moves in between change up to N*N cells, their steps are made one by one with set_cell_num. otherwise
+ * the values are written directly - from the board, or from the nearest checkpoint at or before target if that is
+ * shorter - and the index, the statuses and the hash are rebuilt once, instead of being updated for every step.
+ * @param
+ * board - game's board
+ * curr - the current move
+ * target - the move to go to
+ * back - 1 if target is before curr, 0 if it is after it
+ * count_hid - pointer to the number of hidden cells, updated
+ */
+void goto_move(Board* board, MoveList* curr, MoveList* target, int back, int* count_hid) {
+	int N = board->N; long cost = 0; long ckpt_cost = N*N; int i; int idx;
+	MoveList* node; MoveList* ckpt = target;
+	SingleSet* step;
+	while (ckpt != NULL && ckpt->snapshot == NULL) { /*the nearest checkpoint, and the steps from it to target*/
+		ckpt_cost += ckpt->step_cnt;
+		ckpt = ckpt->prev;
+	}
+	for (node = back ? curr : curr->next; node != NULL && cost <= ckpt_cost; node = back ? node->prev : node->next) {
+		if (node == (back ? target : target->next))
+			break;
+		cost += node->step_cnt;
+	}
+	if (cost <= N*N) { /*few steps, made one by one*/
+		for (node = back ? curr : curr->next; node != (back ? target : target->next); node = back ? node->prev : node->next) {
+			for (i = 0; i < node->step_cnt; i++) {
+				step = &node->steps[back ? node->step_cnt-1-i : i];
+				set_cell_num(board,step->row,step->col,back ? step->prev_val : step->new_val);
+				if (step->prev_val == 0 && step->new_val != 0)
+					*count_hid += back ? 1 : -1;
+				else if (step->prev_val != 0 && step->new_val == 0)
+					*count_hid += back ? -1 : 1;
+			}
+		}
+		return;
+	}
+	if (ckpt == NULL || cost <= ckpt_cost) { /*from the board*/
+		for (node = back ? curr : curr->next; node != (back ? target : target->next); node = back ? node->prev : node->next)
+			apply_steps(board,node,back);
+	}
+	else { /*from the checkpoint*/
+		for (idx = 0; idx < N*N; idx++)
+			NUM_AT(board,idx) = ckpt->snapshot[idx];
+		for (node = ckpt->next; node != target->next; node = node->next)
+			apply_steps(board,node,0);
+	}
+	build_board_index(board);
+	*count_hid = 0;
+	for (idx = 0; idx < N*N; idx++) {
+		if (NUM_AT(board,idx) == 0)
+			*count_hid += 1;
+	}
+}
+
+/**
+ * dig_used - checks whether dig already appears in the row, the column or the block of cell <row,col>.
+ * the cell itself is included in the check.
+ * @param
+ * board - game's board
+ * dig - the checked digit (1..N)
+ * row - row in which the cell is located
+ * col - column in which the cell is located
+ * @return
+ * non zero - if dig appears in one of the cell's units
+ * 0 - otherwise
+ */
+int dig_used(Board* board, int dig, int row, int col) {
+	int w = DIG_WORD(dig);
+	return ((UNIT_BITS(board,ROW_UNIT(board,row))[w] | UNIT_BITS(board,COL_UNIT(board,col))[w]
+			| UNIT_BITS(board,BLOCK_UNIT(board,row,col))[w]) & DIG_MASK(dig)) != 0;
+}
+
+/**
+ * board_solved - checks whether the board is full and no digit repeats in a row, column or block, which makes it a
+ * solution. takes O(1) - the filled cells and the repeated digits are counted by set_cell_num as they change.
+ * @param
+ * board - game's board
+ * @return
+ * 1 - if the board is solved
+ * 0 - otherwise
+ */
+int board_solved(Board* board) {
+	return board->filled_cnt == board->N*board->N && board->dup_cnt == 0;
+}
+
+/**
+ * unit_cell - finds the index of the k-th cell of a unit of the constraint index - a row, a column or a block, whose
+ * cells are counted in row-major order.
+ * @param
+ * board - game's board
+ * unit - index of the unit, numbered as in the constraint index
+ * k - number of the cell in the unit, 0..N-1
+ * @return
+ * index of the cell
+ */
+int unit_cell(Board* board, int unit, int k) {
+	int N = board->N; int block;
+	if (unit < N)
+		return CELL_IDX(board,unit,k);
+	if (unit < 2*N)
+		return CELL_IDX(board,k,unit-N);
+	block = unit-2*N;
+	return CELL_IDX(board,(block/board->m)*board->m + k/board->n,(block%board->m)*board->n + k%board->n);
+}
+
+/**
+ * count_digs - counts the digits in a digit bitset.
+ * @param
+ * set - the bitset
+ * words - number of words in the bitset
+ * @return
+ * number of digits in the set
+ */
+int count_digs(unsigned long* set, int words) {
+	int w; int count = 0; unsigned long bits;
+	for (w = 0; w < words; w++) {
+		for (bits = set[w]; bits != 0; bits &= bits-1)
+			count++;
+	}
+	return count;
+}
+
+/**
+ * next_dig - finds the smallest digit in a digit bitset which is greater than or equal to a given digit.
+ * @param
+ * set - the bitset
+ * words - number of words in the bitset
+ * from - the digit to start from
+ * @return
+ * the digit found, 0 if there is none
+ */
+int next_dig(unsigned long* set, int words, int from) {
+	int w; unsigned long bits;
+	if (from < 1)
+		from = 1;
+	w = DIG_WORD(from);
+	if (w >= words)
+		return 0;
+	bits = set[w] & (~0UL << ((from-1)%WORD_BITS));
+	while (bits == 0) {
+		if (++w == words)
+			return 0;
+		bits = set[w];
+	}
+	from = w*WORD_BITS + 1;
+	while (!(bits & 1UL)) {
+		bits >>= 1;
+		from++;
+	}
+	return from;
+}
+
+/**
+ * cell_candidates - computes the set of digits that may be placed in cell <row,col>, that is - the digits that
+ * appear neither in its row, nor in its column or block.
+ * @param
+ * board - game's board
+ * row - row in which the cell is located
+ * col - column in which the cell is located
+ * cand - bitset of board->words words to fill with the candidates
+ * @return
+ * number of candidates
+ */
+int cell_candidates(Board* board, int row, int col, unsigned long* cand) {
+	unsigned long* r_bits = UNIT_BITS(board,ROW_UNIT(board,row));
+	unsigned long* c_bits = UNIT_BITS(board,COL_UNIT(board,col));
+	unsigned long* b_bits = UNIT_BITS(board,BLOCK_UNIT(board,row,col));
+	int w; int words = board->words; int rest = board->N % WORD_BITS;
+	for (w = 0; w < words; w++)
+		cand[w] = ~(r_bits[w] | c_bits[w] | b_bits[w]);
+	if (rest != 0) /*drop the bits above N*/
+		cand[words-1] &= (1UL << rest) - 1;
+	return count_digs(cand, words);
+}
+
+/**
+ * cell_bits - computes the number of bits that hold any value of a cell, 0 to N.
+ * @param
+ * N - number of cells in one block/row/col
+ * @return
+ * the number of bits, ceil(log2(N+1))
+ */
+int cell_bits(int N) {
+	int bits = 1;
+	while ((N >> bits) != 0)
+		bits++;
+	return bits;
+}
+
+/**
+ * next_rand - advances a random generator (32-bit xorshift) and returns its next number. every thread or task that
+ * needs random numbers keeps its own state, so a seed gives the same numbers regardless of anything else running.
+ * @param
+ * state - the state of the generator, any number (0 is replaced by a fixed non-zero state)
+ * @return
+ * a random number in [1, 2^32)
+ */
+unsigned long next_rand(unsigned long* state) {
+	unsigned long x = *state & 0xFFFFFFFFUL;
+	if (x == 0)
+		x = 0x9E3779B9UL;
+	x ^= (x << 13) & 0xFFFFFFFFUL;
+	x ^= x >> 17;
+	x ^= (x << 5) & 0xFFFFFFFFUL;
+	*state = x;
+	return x;
+}
@@ -4,40 +4,76 @@
  *
  * Supports the following functions:
  *
- * create_num - Initializes each board cell
- * destroy_num - Releases a memory used to initialize the cells
- * create_single_set - creats a SingleSet structure which represents one change of cell on board.
- * create_move - creates a move with one cell change of the board. (a Move node)
- * delete_move - frees the list of Moves.
- * create_move_list - creates a MoveList node, with a given previous Movelist node and a pointer to the first Move on the list of Moves in this node.
+ * first_move - finds the empty node of the move list.
+ * create_move_list - creates a MoveList node, with a given previous Movelist node and room for the given number of steps.
+ * new_move - clears the moves beyond the current move, and adds an empty move after it.
+ * add_step - adds one cell change to a move, in the next free entry of its steps array.
+ * end_move - completes a move after its steps were made, and gives it a checkpoint when due.
  * empty_move_list_forward - frees all forward MoveList nodes including the given one.
- * empty_move_list_backward - frees all backward MoveList nodes including the given one, except for the empty node.
  * empty move list - frees all nodes of the move list except for the empty node and changes the pointer to it.
+ * free_move_pool - frees the memory of the move list, including the empty node.
  * create_stack - creates a stack which top is pointing to NULL.
  * push_to_stack - creates a new stack element, which consists of a cell getting a value, and pushes it on top of the stack.
  * pop_stack - pops the top element of the stack.
+ * set_cell_num - puts a digit in a cell and updates the constraint index, the hash and the erroneous cells of the board.
+ * cell_conflicts - checks whether the digit of a filled cell appears again in its row, column or block.
+ * zobrist_key - gives the Zobrist key of a digit in a cell, from which the board's hash is computed.
+ * build_board_index - rebuilds the constraint index, the statuses and the hash of the board from the cells' values.
+ * goto_move - brings the board to its state after another move of the move list, from the nearest checkpoint if shorter.
+ * dig_used - checks whether a digit appears in the row, column or block of a cell, using the constraint index.
+ * board_solved - checks in O(1) whether the board is full and has no repeated digit in a unit.
+ * unit_cell - finds the index of a cell of a row, column or block of the constraint index.
+ * cell_candidates - computes the bitset of digits that may be placed in a cell.
+ * count_digs - counts the digits in a digit bitset.
+ * next_dig - finds the next digit in a digit bitset.
+ * cell_bits - computes the number of bits that hold the values of a cell.
+ * next_rand - returns the next number of a seedable random generator.
  */
 
-extern Num* create_num(int n);
+extern MoveList* first_move();
 
-extern void destroy_num (Num* n);
+extern MoveList* create_move_list (MoveList* tail, int steps);
 
-extern SingleSet* create_single_set(int prev, int new, int col, int row);
+extern MoveList* new_move (MoveList* curr_move, int steps);
 
-extern Move* create_move(SingleSet* cell_set);
+extern void add_step (MoveList* move, int prev_val, int new_val, int col, int row);
 
-extern void delete_move (Move* head);
-
-extern MoveList* create_move_list (MoveList* tail, Move* move);
+extern void end_move (MoveList* move, Board* board);
 
 extern void empty_move_list_forward (MoveList* curr_move);
 
-extern MoveList* empty_move_list_backward (MoveList* curr_move);
-
 extern void empty_move_list(MoveList** curr_move);
 
+extern void free_move_pool();
+
 extern Stack* create_stack();
 
 extern void push_to_stack (int dig, int row, int col, Stack *stk );
 
 extern void pop_stack (Stack *stk);
+
+extern void set_cell_num(Board* board, int row, int col, int dig);
+
+extern int cell_conflicts(Board* board, int idx);
+
+extern unsigned long zobrist_key(int idx, int dig);
+
+extern void build_board_index(Board* board);
+
+extern void goto_move(Board* board, MoveList* curr, MoveList* target, int back, int* count_hid);
+
+extern int board_solved(Board* board);
+
+extern int unit_cell(Board* board, int unit, int k);
+
+extern int dig_used(Board* board, int dig, int row, int col);
+
+extern int cell_candidates(Board* board, int row, int col, unsigned long* cand);
+
+extern int count_digs(unsigned long* set, int words);
+
+extern int next_dig(unsigned long* set, int words, int from);
+
+extern int cell_bits(int N);
+
+extern unsigned long next_rand(unsigned long* state);
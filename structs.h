@@ -1,6 +1,10 @@
 #ifndef STRUCTS_H_
 #define STRUCTS_H_
 
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+
 /**
 * This module consists of declerations of structures and enums used in the program.
 */
@@ -26,6 +30,74 @@ typedef struct sudoku_number {
 	STAT status;
 } Num;
 
+/**
+* Type represents the Sudoku board - a single contiguous array of N*N cells in row-major order.
+* When compiled with -DBOARD_SOA, the cells are kept as separate arrays of num, alt_num and status (struct-of-arrays).
+* Cells should be accessed only through the CELL_* macros below, which work with both layouts.
+*/
+typedef struct sudoku_board {
+	int m; /*number of rows in one block*/
+	int n; /*number of columns in one block*/
+	int N; /*number of cells in one row/col*/
+#ifdef BOARD_SOA
+	int* num;
+	int* alt_num;
+	STAT* status;
+#else
+	Num* cells;
+#endif
+	/* constraint index over the cells' num values. units are numbered rows 0..N-1, columns N..2N-1, blocks 2N..3N-1 */
+	int words; /*number of bitset words needed to hold N digits*/
+	int* unit_cnt; /*unit_cnt[unit*(N+1)+dig] - number of occurrences of dig in unit*/
+	unsigned long* unit_used; /*unit_used[unit*words+w] - bitset of the digits used in unit, digit d is bit d-1*/
+	int* unit_sum; /*unit_sum[unit*(N+1)+dig] - sum of the indices of the cells holding dig in unit*/
+	int err_cnt; /*number of ERRONEOUS cells - filled, not fixed cells whose digit appears again in one of their units*/
+	int filled_cnt; /*number of filled cells*/
+	int dup_cnt; /*number of digits that appear more than once in a unit, summed over the units*/
+	/* Zobrist hash of the cells' num values, and the solution cached for the board (see solution_grid) */
+	unsigned long hash; /*xor of the keys (see zobrist_key) of the values of all filled cells*/
+	int* sol; /*cached solution, N*N values in row-major order*/
+	int sol_state; /*1 - sol is a solution of the board, -1 - the board was found unsolvable, 0 - nothing cached*/
+	unsigned long sol_hash; /*hash of the board when sol_state was found*/
+	int sol_diff; /*number of filled cells whose value differs from sol, kept while sol_state == 1*/
+} Board;
+
+/*largest N of a board - N*N*N, the largest sum of the indices of a digit's cells in a unit (unit_sum), fits in an int*/
+#define MAX_N 1290
+
+/*index of cell <row,col> in the board's cell array, and back*/
+#define CELL_IDX(board,row,col) ((row)*(board)->N+(col))
+#define IDX_ROW(board,idx) ((idx)/(board)->N)
+#define IDX_COL(board,idx) ((idx)%(board)->N)
+
+#ifdef BOARD_SOA
+#define NUM_AT(board,idx) ((board)->num[idx])
+#define ALT_AT(board,idx) ((board)->alt_num[idx])
+#define STAT_AT(board,idx) ((board)->status[idx])
+#else
+#define NUM_AT(board,idx) ((board)->cells[idx].num)
+#define ALT_AT(board,idx) ((board)->cells[idx].alt_num)
+#define STAT_AT(board,idx) ((board)->cells[idx].status)
+#endif
+
+#define CELL_NUM(board,row,col) NUM_AT(board,CELL_IDX(board,row,col))
+#define CELL_ALT(board,row,col) ALT_AT(board,CELL_IDX(board,row,col))
+#define CELL_STAT(board,row,col) STAT_AT(board,CELL_IDX(board,row,col))
+
+/*units of the constraint index containing cell <row,col>*/
+#define ROW_UNIT(board,row) (row)
+#define COL_UNIT(board,col) ((board)->N+(col))
+#define BLOCK_UNIT(board,row,col) (2*(board)->N+((row)/(board)->m)*(board)->m+(col)/(board)->n)
+
+/*digit bitsets*/
+#define WORD_BITS ((int) (CHAR_BIT*sizeof(unsigned long)))
+#define DIG_WORD(dig) (((dig)-1)/WORD_BITS)
+#define DIG_MASK(dig) (1UL << (((dig)-1)%WORD_BITS))
+#define UNIT_BITS(board,unit) ((board)->unit_used+(unit)*(board)->words)
+#define UNIT_CNT(board,unit,dig) ((board)->unit_cnt[(unit)*((board)->N+1)+(dig)])
+/*while dig occurs once in unit, the index of the cell holding it*/
+#define UNIT_SUM(board,unit,dig) ((board)->unit_sum[(unit)*((board)->N+1)+(dig)])
+
 /**
 * Type represents game mode
 */
@@ -35,6 +107,14 @@ typedef enum game_mode {
 	EDIT
 } MODE;
 
+/**
+* Type represents the engine used to solve the board
+*/
+typedef enum solver_engine {
+	GUROBI_ENGINE,
+	NATIVE_ENGINE
+} ENGINE;
+
 /**
 * Type represents a single cell 'set' (change of cell's value).
 */
@@ -44,25 +124,83 @@ typedef struct set_cell {
 	int col; int row; /*coordinates of cell*/
 } SingleSet;
 
-/**
- * type is a singly linked list which as a whole reprsents one move of the user. 
- * Each node contains a SingleSet, that is, each node represents one cell change done on board in this move.
- */
-typedef struct move {
-	SingleSet* change; /* set of one cell*/
-	struct move* next; /* next step in this move*/
-} Move;
-
 /**
 * Type is a doubly linked list which as a whole represents the undo/redo move list of the program.
-* Each node contains a Move, that is, each node represents on move done by the user (set/autofill/generate).
+* Each node represents one move done by the user (set/autofill/generate), and holds its cell changes packed in one
+* array. every few moves a node also holds a checkpoint - the values of all the cells after its move - so that the
+* board can be brought to any point of the list from the nearest checkpoint, instead of replaying every move.
 */
 typedef struct move_list {
-	Move* head_move;
+	SingleSet* steps; /*the cell changes of the move, in the order they were made*/
+	int step_cnt; /*number of cell changes*/
+	int since_ckpt; /*number of cell changes made since the last checkpoint, including this move's*/
+	int* snapshot; /*checkpoint - N*N cell values in row-major order, NULL if the node has none*/
 	struct move_list* next;
 	struct move_list* prev;
 } MoveList;
 
+/**
+* Type represents a chunk of memory from which the nodes of the move list are allocated, one after the other.
+*/
+typedef struct pool_chunk {
+	struct pool_chunk* next;
+	size_t cap; /*number of bytes in the chunk*/
+	size_t used; /*number of bytes allocated from the chunk*/
+} PoolChunk;
+
+/**
+* Type represents the memory of the move list - a list of chunks, of which the nodes are allocated in order.
+*/
+typedef struct move_pool {
+	PoolChunk* first;
+	PoolChunk* cur; /*chunk of the last allocated node*/
+} MovePool;
+
+/**
+* Type represents a reader of the tokens of board files - a buffer which holds the whole content of a file (mapped to
+* memory), or a part of a stream at a time.
+*/
+typedef struct token_reader {
+	FILE* fp; /*the stream the buffer is refilled from, NULL if the buffer holds all the content*/
+	char* buf;
+	size_t len; /*number of bytes in the buffer*/
+	size_t pos; /*position of the next token in the buffer*/
+	size_t cap; /*size of the buffer*/
+	int eof; /*set when the stream ended*/
+} TokenReader;
+
+/**
+* The binary board format (see save_bin and read_board) - a header of BIN_HEADER bytes: the magic "SDKB", the version,
+* the flags, and m and n as 16-bit little-endian numbers. it is followed by the N*N values in row-major order, packed
+* least significant bit first at cell_bits(N) bits per cell (0 for an empty cell), and when the flags have BIN_FIXED,
+* by a bitmap of the fixed cells in the same order, one bit per cell.
+*/
+#define BIN_MAGIC "SDKB"
+#define BIN_VERSION 1
+#define BIN_HEADER 10
+#define BIN_FIXED 1
+#define BIN_BYTES(bits) (((bits)+7)/8)
+
+/**
+* Type represents a cell of a RingQueue - a value, and the sequence number that tells in which round of the queue it
+* may be pushed or popped.
+*/
+typedef struct ring_cell {
+	unsigned long seq;
+	long val;
+} RingCell;
+
+/**
+* Type represents a bounded lock-free queue of values, shared by any number of producer and consumer threads.
+*/
+typedef struct ring_queue {
+	RingCell* cells; /*mask+1 cells, a power of 2*/
+	unsigned long mask;
+	unsigned long tail; /*number of pushes started*/
+	unsigned long head; /*number of pops started*/
+	long max_depth; /*largest number of values seen in the queue*/
+} RingQueue;
+
 /**
  * type represents element of stack of cell changes, for the exhaustive backtrackign.
  */
@@ -82,4 +220,25 @@ typedef struct stack {
 } Stack;
 
 
+/**
+* Type represents a Dancing Links (Algorithm X) exact cover matrix of a board.
+* columns are the constraints - cell filled, digit in row, digit in column and digit in block.
+* rows are the possible placements of a digit in an empty cell.
+* nodes are kept in parallel arrays, node 0 is the root and nodes 1..ncols are the column headers.
+*/
+typedef struct dlx_matrix {
+	int* left; int* right; int* up; int* down; /*links of each node*/
+	int* col; /*column header of each node*/
+	int* size; /*number of nodes in each column, indexed by header*/
+	int* row_cell; int* row_dig; /*cell index and digit placed by each row*/
+	int* node_row; /*row of each node*/
+	int* row_node; /*first node of each row*/
+	int ncols; /*number of columns*/
+	int nrows; /*number of rows*/
+	int infeasible; /*set when the filled cells already violate a constraint*/
+	long count; /*number of solutions found*/
+	long cap; /*stop after cap solutions, 0 for no cap*/
+	long nodes; /*number of search nodes visited*/
+} DLXMatrix;
+
 #endif